@@ -1,11 +1,35 @@
 #include "json.h"
 
+#include <charconv>
+#include <iterator>
+
 using namespace std;
 
 namespace json {
 
     namespace {
 
+        // [first, last)     JSON. from_chars    
+        //   double   
+        Node::Value ConvertNumber(const char* first, const char* last, bool is_int) {
+            Node::Value value;
+            from_chars_result result;
+            if (is_int) {
+                int number = 0;
+                result = from_chars(first, last, number);
+                value = number;
+            }
+            else {
+                double number = 0.0;
+                result = from_chars(first, last, number);
+                value = number;
+            }
+            if (result.ec != errc{} || result.ptr != last) {
+                throw ParsingError("Failed to convert " + string(first, last) + " to number");
+            }
+            return value;
+        }
+
         Node LoadNode(istream& input);
 
         Node LoadArray(istream& input) {
@@ -67,15 +91,7 @@ namespace json {
                 is_int = false;
             }
 
-            try {
-                if (is_int) {
-                    return Node(stoi(parsed_num));
-                }
-                return Node(stod(parsed_num));
-            }
-            catch (...) {
-                throw ParsingError("Failed to convert " + parsed_num + " to number");
-            }
+            return Node(ConvertNumber(parsed_num.data(), parsed_num.data() + parsed_num.size(), is_int));
         }
 
         Node LoadString(istream& input) {
@@ -166,6 +182,329 @@ namespace json {
             }
         }
 
+        void ParseNode(istream& input, SaxHandler& handler) {
+            char c;
+            if (!(input >> c)) {
+                throw ParsingError("Unexpected end of input");
+            }
+            if (c == '[') {
+                handler.StartArray();
+                for (char next; input >> next && next != ']';) {
+                    if (next != ',') {
+                        input.putback(next);
+                    }
+                    ParseNode(input, handler);
+                }
+                if (input.fail() && input.eof()) {
+                    throw ParsingError("Array parsing error: missing closing ']'");
+                }
+                handler.EndArray();
+            }
+            else if (c == '{') {
+                handler.StartDict();
+                for (char next; input >> next && next != '}';) {
+                    if (next == ',') {
+                        input >> next;
+                    }
+                    handler.Key(get<string>(LoadString(input).GetValue()));
+                    input >> next;
+                    ParseNode(input, handler);
+                }
+                if (input.fail() && input.eof()) {
+                    throw ParsingError("Dict parsing error: missing closing '}'");
+                }
+                handler.EndDict();
+            }
+            else if (c == '"') {
+                handler.String(get<string>(LoadString(input).GetValue()));
+            }
+            else if (isdigit(c) || c == '-' || c == '.') {
+                input.putback(c);
+                handler.Value(move(LoadNumber(input).GetValue()));
+            }
+            else if (isalpha(c)) {
+                input.putback(c);
+                handler.Value(move(LoadBoolOrNull(input).GetValue()));
+            }
+            else {
+                throw ParsingError("Invalid character");
+            }
+        }
+
+        //           
+        class BufferParser {
+        public:
+            explicit BufferParser(string_view input)
+                : pos_(input.data())
+                , end_(input.data() + input.size()) {
+            }
+
+            void ParseDocument(SaxHandler& handler) {
+                ParseNode(handler);
+                if (SkipSpaces()) {
+                    throw ParsingError("Unexpected data after the document");
+                }
+            }
+
+        private:
+            static bool IsSpace(char c) {
+                return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+            }
+
+            static bool IsDigit(char c) {
+                return c >= '0' && c <= '9';
+            }
+
+            // false,   
+            bool SkipSpaces() {
+                while (pos_ != end_ && IsSpace(*pos_)) {
+                    ++pos_;
+                }
+                return pos_ != end_;
+            }
+
+            char NextChar() {
+                if (!SkipSpaces()) {
+                    throw ParsingError("Unexpected end of input");
+                }
+                return *pos_++;
+            }
+
+            void ParseNode(SaxHandler& handler) {
+                const char c = NextChar();
+                if (c == '[') {
+                    handler.StartArray();
+                    for (char next = NextChar(); next != ']'; next = NextChar()) {
+                        if (next != ',') {
+                            --pos_;
+                        }
+                        ParseNode(handler);
+                    }
+                    handler.EndArray();
+                }
+                else if (c == '{') {
+                    handler.StartDict();
+                    for (char next = NextChar(); next != '}'; next = NextChar()) {
+                        if (next == ',') {
+                            next = NextChar();
+                        }
+                        if (next != '"') {
+                            throw ParsingError("Dict parsing error: key is expected");
+                        }
+                        handler.Key(ParseString());
+                        if (NextChar() != ':') {
+                            throw ParsingError("Dict parsing error: ':' is expected");
+                        }
+                        ParseNode(handler);
+                    }
+                    handler.EndDict();
+                }
+                else if (c == '"') {
+                    handler.String(ParseString());
+                }
+                else if (IsDigit(c) || c == '-' || c == '.') {
+                    --pos_;
+                    handler.Value(ParseNumber());
+                }
+                else if (isalpha(static_cast<unsigned char>(c))) {
+                    --pos_;
+                    handler.Value(ParseBoolOrNull());
+                }
+                else {
+                    throw ParsingError("Invalid character");
+                }
+            }
+
+            //   escape- -  ,    unescaped_
+            string_view ParseString() {
+                const char* begin = pos_;
+                while (pos_ != end_ && *pos_ != '"' && *pos_ != '\\') {
+                    if (*pos_ == '\n' || *pos_ == '\r') {
+                        throw ParsingError("Unexpected end of line");
+                    }
+                    ++pos_;
+                }
+                if (pos_ == end_) {
+                    throw ParsingError("String parsing error");
+                }
+                if (*pos_ == '"') {
+                    return { begin, static_cast<size_t>(pos_++ - begin) };
+                }
+
+                unescaped_.assign(begin, pos_);
+                while (true) {
+                    if (pos_ == end_) {
+                        throw ParsingError("String parsing error");
+                    }
+                    const char ch = *pos_++;
+                    if (ch == '"') {
+                        break;
+                    }
+                    if (ch == '\n' || ch == '\r') {
+                        throw ParsingError("Unexpected end of line");
+                    }
+                    if (ch != '\\') {
+                        unescaped_.push_back(ch);
+                        continue;
+                    }
+                    if (pos_ == end_) {
+                        throw ParsingError("String parsing error");
+                    }
+                    const char escaped_char = *pos_++;
+                    switch (escaped_char) {
+                    case 'n':
+                        unescaped_.push_back('\n');
+                        break;
+                    case 't':
+                        unescaped_.push_back('\t');
+                        break;
+                    case 'r':
+                        unescaped_.push_back('\r');
+                        break;
+                    case '"':
+                        unescaped_.push_back('"');
+                        break;
+                    case '\\':
+                        unescaped_.push_back('\\');
+                        break;
+                    default:
+                        throw ParsingError("Unrecognized escape sequence \\"s + escaped_char);
+                    }
+                }
+                return unescaped_;
+            }
+
+            void SkipDigits() {
+                if (pos_ == end_ || !IsDigit(*pos_)) {
+                    throw ParsingError("A digit is expected");
+                }
+                while (pos_ != end_ && IsDigit(*pos_)) {
+                    ++pos_;
+                }
+            }
+
+            Node::Value ParseNumber() {
+                const char* begin = pos_;
+                if (*pos_ == '-') {
+                    ++pos_;
+                }
+                if (pos_ != end_ && *pos_ == '0') {
+                    ++pos_;
+                }
+                else {
+                    SkipDigits();
+                }
+
+                bool is_int = true;
+                if (pos_ != end_ && *pos_ == '.') {
+                    ++pos_;
+                    SkipDigits();
+                    is_int = false;
+                }
+
+                if (pos_ != end_ && (*pos_ == 'e' || *pos_ == 'E')) {
+                    ++pos_;
+                    if (pos_ != end_ && (*pos_ == '+' || *pos_ == '-')) {
+                        ++pos_;
+                    }
+                    SkipDigits();
+                    is_int = false;
+                }
+
+                return ConvertNumber(begin, pos_, is_int);
+            }
+
+            Node::Value ParseBoolOrNull() {
+                const char* begin = pos_;
+                while (pos_ != end_ && isalpha(static_cast<unsigned char>(*pos_))) {
+                    ++pos_;
+                }
+                const string_view value(begin, static_cast<size_t>(pos_ - begin));
+                if (value == "true"sv) {
+                    return true;
+                }
+                else if (value == "false"sv) {
+                    return false;
+                }
+                else if (value == "null"sv) {
+                    return nullptr;
+                }
+                else {
+                    throw ParsingError("Invalid value");
+                }
+            }
+
+            const char* pos_;
+            const char* end_;
+            string unescaped_;
+        };
+
+        //     
+        class DocumentBuilder final : public SaxHandler {
+        public:
+            void StartDict() override {
+                nodes_.emplace_back(Dict{});
+            }
+
+            void Key(string_view key) override {
+                keys_.emplace_back(key);
+            }
+
+            void EndDict() override {
+                EndContainer();
+            }
+
+            void StartArray() override {
+                nodes_.emplace_back(Array{});
+            }
+
+            void EndArray() override {
+                EndContainer();
+            }
+
+            void String(string_view value) override {
+                Add(Node(string(value)));
+            }
+
+            //     :   variant   GCC 12
+            //   -Wmaybe-uninitialized
+            void Value(Node::Value value) override {
+                visit([this](auto& scalar) {
+                    Add(Node(move(scalar)));
+                    }, value);
+            }
+
+            Node ExtractRoot() {
+                return move(root_);
+            }
+
+        private:
+            void EndContainer() {
+                Node node = move(nodes_.back());
+                nodes_.pop_back();
+                Add(move(node));
+            }
+
+            void Add(Node node) {
+                if (nodes_.empty()) {
+                    root_ = move(node);
+                    return;
+                }
+                Node::Value& parent = nodes_.back().GetValue();
+                if (Array* array = get_if<Array>(&parent)) {
+                    array->push_back(move(node));
+                }
+                else {
+                    get<Dict>(parent).emplace(move(keys_.back()), move(node));
+                    keys_.pop_back();
+                }
+            }
+
+            Node root_;
+            vector<Node> nodes_;
+            vector<string> keys_;
+        };
+
         Node LoadNode(istream& input) {
             char c;
             input >> c;
@@ -268,13 +607,30 @@ namespace json {
         return Document{ LoadNode(input) };
     }
 
+    Document Load(string_view input) {
+        DocumentBuilder builder;
+        BufferParser(input).ParseDocument(builder);
+        return Document{ builder.ExtractRoot() };
+    }
+
+    void Parse(istream& input, SaxHandler& handler) {
+        ParseNode(input, handler);
+    }
+
+    void Parse(string_view input, SaxHandler& handler) {
+        BufferParser(input).ParseDocument(handler);
+    }
+
     void PrintValue(const bool& value, const PrintContext& ctx) {
         ctx.out << (value ? "true" : "false");
     }
 
-    template <typename Value>
-    void PrintValue(const Value& value, const PrintContext& ctx) {
-        ctx.out << value;
+    // int  double:  ,       
+    template <typename Number>
+    void PrintValue(Number value, const PrintContext& ctx) {
+        char buffer[32];
+        const auto result = to_chars(std::begin(buffer), std::end(buffer), value);
+        ctx.out.write(buffer, result.ptr - buffer);
     }
 
     void PrintValue(nullptr_t, const PrintContext& ctx) {
@@ -4,6 +4,7 @@
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <variant>
 #include <vector>
 
@@ -71,7 +72,30 @@ namespace json {
         PrintContext Indented() const;
     };
 
+    //    .    :
+    //   ,  
+    class SaxHandler {
+    public:
+        virtual ~SaxHandler() = default;
+
+        virtual void StartDict() = 0;
+        //         
+        virtual void Key(std::string_view key) = 0;
+        virtual void EndDict() = 0;
+        virtual void StartArray() = 0;
+        virtual void EndArray() = 0;
+        virtual void String(std::string_view value) = 0;
+        // null, bool, int  double
+        virtual void Value(Node::Value value) = 0;
+    };
+
     Document Load(std::istream& input);
+    //   ,   .   escape-
+    //    string_view  ,  
+    Document Load(std::string_view input);
+    //   JSON-,       
+    void Parse(std::istream& input, SaxHandler& handler);
+    void Parse(std::string_view input, SaxHandler& handler);
     void Print(const Document& doc, std::ostream& output);
     void PrintNode(const Node& node, const PrintContext& ctx);
 
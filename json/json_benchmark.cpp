@@ -0,0 +1,182 @@
+//       ,    :   .
+//   ,  :
+//   g++ -std=c++17 -O2 json/json.cpp json/json_benchmark.cpp -o json_benchmark
+//   ./json_benchmark [ ,   1000000]
+
+#include "json.h"
+
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+
+using namespace std;
+
+namespace {
+
+    using Clock = chrono::steady_clock;
+
+    double SecondsSince(Clock::time_point start) {
+        return chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    //         
+    json::Document MakeCoordinateDocument(size_t stop_count, unsigned seed) {
+        mt19937 generator(seed);
+        uniform_real_distribution<double> latitude(43.5, 43.7), longitude(39.6, 39.9);
+        uniform_int_distribution<int> meters(100, 5000);
+
+        json::Array stops;
+        stops.reserve(stop_count);
+        for (size_t i = 0; i < stop_count; ++i) {
+            json::Dict road_distances;
+            road_distances["Stop " + to_string((i + 1) % stop_count)] = meters(generator);
+            road_distances["Stop " + to_string((i + 7) % stop_count)] = meters(generator);
+
+            json::Dict stop;
+            stop["type"] = "Stop"s;
+            stop["name"] = "Stop " + to_string(i);
+            stop["latitude"] = latitude(generator);
+            stop["longitude"] = longitude(generator);
+            stop["road_distances"] = move(road_distances);
+            stops.emplace_back(move(stop));
+        }
+        return json::Document(json::Node(move(stops)));
+    }
+
+    //  ,   :   
+    class NumberCounter : public json::SaxHandler {
+    public:
+        void StartDict() override {}
+        void Key(string_view) override {}
+        void EndDict() override {}
+        void StartArray() override {}
+        void EndArray() override {}
+        void String(string_view) override {}
+        void Value(json::Node::Value value) override {
+            if (holds_alternative<int>(value) || holds_alternative<double>(value)) {
+                ++count_;
+            }
+        }
+
+        size_t GetCount() const { return count_; }
+
+    private:
+        size_t count_ = 0;
+    };
+
+    //   :    stod  ,  ostream  
+    double ParseLegacy(const string& text) {
+        return stod(text);
+    }
+
+    void PrintLegacy(double value, ostream& out) {
+        out << value << ' ';
+    }
+
+    double ParseFromChars(const string& text) {
+        double value = 0.0;
+        from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    }
+
+    void PrintToChars(double value, ostream& out) {
+        char buffer[32];
+        const auto result = to_chars(begin(buffer), end(buffer), value);
+        out.write(buffer, result.ptr - buffer);
+        out << ' ';
+    }
+
+    template <typename Parser>
+    double MeasureParsing(const vector<string>& texts, Parser parse, double& checksum) {
+        const Clock::time_point start = Clock::now();
+        for (const string& text : texts) {
+            checksum += parse(text);
+        }
+        return SecondsSince(start);
+    }
+
+    template <typename Printer>
+    double MeasurePrinting(const vector<double>& values, Printer print, size_t& bytes) {
+        ostringstream out;
+        const Clock::time_point start = Clock::now();
+        for (const double value : values) {
+            print(value, out);
+        }
+        const double seconds = SecondsSince(start);
+        bytes = out.str().size();
+        return seconds;
+    }
+
+    void BenchmarkNumbers(size_t count) {
+        mt19937 generator(2);
+        uniform_real_distribution<double> coordinate(39.6, 43.7);
+        vector<double> values(count);
+        vector<string> texts;
+        texts.reserve(count);
+        for (double& value : values) {
+            value = coordinate(generator);
+            char buffer[32];
+            texts.emplace_back(buffer, to_chars(begin(buffer), end(buffer), value).ptr);
+        }
+
+        double legacy_sum = 0.0, fast_sum = 0.0;
+        const double legacy_parse = MeasureParsing(texts, ParseLegacy, legacy_sum);
+        const double fast_parse = MeasureParsing(texts, ParseFromChars, fast_sum);
+        size_t legacy_bytes = 0, fast_bytes = 0;
+        const double legacy_print = MeasurePrinting(values, PrintLegacy, legacy_bytes);
+        const double fast_print = MeasurePrinting(values, PrintToChars, fast_bytes);
+
+        size_t exact = 0;
+        for (size_t i = 0; i < count; ++i) {
+            exact += ParseFromChars(texts[i]) == values[i];
+        }
+
+        cout << "numbers: " << count << '\n'
+             << "  parse stod " << legacy_parse << " s, from_chars " << fast_parse << " s"
+             << (legacy_sum == fast_sum ? "" : " (sums differ)") << '\n'
+             << "  print ostream " << legacy_print << " s (" << legacy_bytes << " B), to_chars "
+             << fast_print << " s (" << fast_bytes << " B)\n"
+             << "  to_chars/from_chars round trip exact: " << exact << " of " << count << '\n';
+    }
+
+    void BenchmarkDocument(size_t stop_count) {
+        const json::Document document = MakeCoordinateDocument(stop_count, 1);
+
+        Clock::time_point start = Clock::now();
+        ostringstream out;
+        json::Print(document, out);
+        const string text = out.str();
+        const double print_seconds = SecondsSince(start);
+
+        start = Clock::now();
+        NumberCounter counter;
+        json::Parse(string_view(text), counter);
+        const double sax_seconds = SecondsSince(start);
+
+        start = Clock::now();
+        const json::Document from_buffer = json::Load(string_view(text));
+        const double buffer_seconds = SecondsSince(start);
+
+        start = Clock::now();
+        istringstream input(text);
+        const json::Document from_stream = json::Load(input);
+        const double stream_seconds = SecondsSince(start);
+
+        const double megabytes = text.size() / 1e6;
+        cout << "document: " << stop_count << " stops, " << megabytes << " MB, " << counter.GetCount() << " numbers\n"
+             << "  Print " << print_seconds << " s\n"
+             << "  Parse(string_view) " << sax_seconds << " s, " << megabytes / sax_seconds << " MB/s\n"
+             << "  Load(string_view) " << buffer_seconds << " s, " << megabytes / buffer_seconds << " MB/s\n"
+             << "  Load(istream) " << stream_seconds << " s, " << megabytes / stream_seconds << " MB/s\n"
+             << "  round trip exact: " << (from_buffer == document && from_stream == document ? "yes" : "no") << '\n';
+    }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const size_t stop_count = argc > 1 ? static_cast<size_t>(strtoull(argv[1], nullptr, 10)) : 1000000;
+    BenchmarkNumbers(stop_count * 2);
+    BenchmarkDocument(stop_count);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//    :       .
+//     
+template <typename T>
+class ArrayView {
+public:
+    ArrayView() = default;
+    ArrayView(const T* first, const T* last)
+        : first_(first)
+        , last_(last) {
+    }
+    ArrayView(const std::vector<T>& values)
+        : first_(values.data())
+        , last_(values.data() + values.size()) {
+    }
+
+    const T* begin() const { return first_; }
+    const T* end()   const { return last_; }
+    const T* data()  const { return first_; }
+    const T& operator[](size_t index) const { return first_[index]; }
+    const T& front() const { return *first_; }
+    const T& back()  const { return *(last_ - 1); }
+    size_t size()  const { return static_cast<size_t>(last_ - first_); }
+    bool   empty() const { return first_ == last_; }
+
+private:
+    const T* first_ = nullptr;
+    const T* last_ = nullptr;
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "router.h"
+#include "search_workspace.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <vector>
+
+namespace graph {
+
+    template <typename Weight>
+    class BidirectionalRouter : public RouteBuilder<Weight> {
+    private:
+        using Graph = DirectedWeightedGraph<Weight>;
+
+    public:
+        using typename RouteBuilder<Weight>::RouteInfo;
+
+        explicit BidirectionalRouter(const Graph& graph);
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    private:
+        struct QueueItem {
+            Weight weight;
+            VertexId vertex;
+
+            bool operator>(const QueueItem& other) const {
+                return weight > other.weight;
+            }
+        };
+        using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+        struct SearchSide {
+            explicit SearchSide(SearchWorkspace<Weight>& workspace)
+                : workspace(workspace) {
+            }
+
+            SearchWorkspace<Weight>& workspace;
+            Queue queue;
+
+            void Reach(VertexId vertex, Weight weight, EdgeId edge_id) {
+                workspace.Reach(vertex, weight, edge_id);
+                queue.push({ weight, vertex });
+            }
+
+            bool SkipSettled() {
+                while (!queue.empty() && queue.top().weight > workspace.GetWeight(queue.top().vertex)) {
+                    queue.pop();
+                }
+                return !queue.empty();
+            }
+        };
+
+        struct Meeting {
+            Weight weight;
+            VertexId vertex;
+        };
+
+        template <typename ForEachEdge>
+        void Step(SearchSide& side, const SearchSide& other_side, std::optional<Meeting>& meeting,
+            ForEachEdge for_each_edge) const {
+            const QueueItem item = side.queue.top();
+            side.queue.pop();
+            for_each_edge(item.vertex, [&](EdgeId edge_id, VertexId vertex, Weight edge_weight) {
+                const Weight candidate_weight = item.weight + edge_weight;
+                if (side.workspace.IsReached(vertex) && side.workspace.GetWeight(vertex) <= candidate_weight) {
+                    return;
+                }
+                side.Reach(vertex, candidate_weight, edge_id);
+                if (const auto other_weight = other_side.workspace.FindWeight(vertex)) {
+                    const Weight total_weight = candidate_weight + *other_weight;
+                    if (!meeting || total_weight < meeting->weight) {
+                        meeting = Meeting{ total_weight, vertex };
+                    }
+                }
+                });
+        }
+
+        static constexpr Weight ZERO_WEIGHT{};
+        static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+        const Graph& graph_;
+    };
+
+    template <typename Weight>
+    BidirectionalRouter<Weight>::BidirectionalRouter(const Graph& graph)
+        : graph_(graph)
+    {
+        if (!graph.HasIncomingIndex()) {
+            throw std::logic_error("Bidirectional search requires an incoming index");
+        }
+        for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+            if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+    }
+
+    template <typename Weight>
+    std::optional<typename BidirectionalRouter<Weight>::RouteInfo> BidirectionalRouter<Weight>::BuildRoute(VertexId from,
+        VertexId to) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+
+        SearchSide forward(GetThreadWorkspace<Weight>(0, vertex_count));
+        SearchSide backward(GetThreadWorkspace<Weight>(1, vertex_count));
+        forward.Reach(from, ZERO_WEIGHT, NO_EDGE);
+        backward.Reach(to, ZERO_WEIGHT, NO_EDGE);
+        std::optional<Meeting> meeting;
+        if (from == to) {
+            meeting = Meeting{ ZERO_WEIGHT, from };
+        }
+
+        const auto for_each_outgoing = [this](VertexId vertex, auto callback) {
+            graph_.ForEachIncidentEdge(vertex, callback);
+        };
+        const auto for_each_incoming = [this](VertexId vertex, auto callback) {
+            graph_.ForEachIncomingEdge(vertex, callback);
+        };
+
+        while (forward.SkipSettled() && backward.SkipSettled()) {
+            const Weight forward_weight = forward.queue.top().weight;
+            const Weight backward_weight = backward.queue.top().weight;
+            if (meeting && forward_weight + backward_weight >= meeting->weight) {
+                break;
+            }
+            if (forward_weight <= backward_weight) {
+                Step(forward, backward, meeting, for_each_outgoing);
+            }
+            else {
+                Step(backward, forward, meeting, for_each_incoming);
+            }
+        }
+
+        if (!meeting) {
+            return std::nullopt;
+        }
+        std::vector<EdgeId> edges;
+        for (VertexId vertex = meeting->vertex; vertex != from; vertex = graph_.GetEdge(edges.back()).from) {
+            edges.push_back(forward.workspace.GetPrevEdge(vertex));
+        }
+        std::reverse(edges.begin(), edges.end());
+        for (VertexId vertex = meeting->vertex; vertex != to; vertex = graph_.GetEdge(edges.back()).to) {
+            edges.push_back(backward.workspace.GetPrevEdge(vertex));
+        }
+
+        return RouteInfo{ meeting->weight, std::move(edges) };
+    }
+
+}  // namespace graph
@@ -0,0 +1,373 @@
+#include "catalogue_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "transport_catalogue.h"
+
+namespace {
+
+    enum Section : size_t {
+        STRING_POOL,
+        STOP_NAME_OFFSETS,
+        STOP_LATITUDES,
+        STOP_LONGITUDES,
+        STOP_BUS_OFFSETS,
+        STOP_BUSES,
+        BUS_NAME_OFFSETS,
+        BUS_STOP_OFFSETS,
+        BUS_STOPS,
+        BUS_ROUNDTRIP,
+        BUS_FINAL_STOPS,
+        BUS_DEPARTURE_OFFSETS,
+        BUS_DEPARTURES,
+        BUS_UNIQUE_STOPS,
+        BUS_LENGTHS,
+        BUS_CURVATURES,
+        BUS_PREFIX_DISTANCES,
+        STOP_NAME_INDEX,
+        BUS_NAME_INDEX,
+        DISTANCE_SLOT_KEYS,
+        DISTANCE_SLOT_METERS,
+        SECTION_COUNT,
+    };
+
+    //    ,   Section
+    constexpr size_t ELEMENT_SIZES[SECTION_COUNT] = {
+        sizeof(char), sizeof(uint64_t), sizeof(double), sizeof(double), sizeof(uint64_t), sizeof(BusId),
+        sizeof(uint64_t), sizeof(uint64_t), sizeof(StopId), sizeof(uint32_t), sizeof(StopId),
+        sizeof(uint64_t), sizeof(double), sizeof(uint64_t), sizeof(double), sizeof(double), sizeof(double),
+        sizeof(StopId), sizeof(BusId), sizeof(uint64_t), sizeof(int32_t) };
+
+    constexpr char MAGIC[8] = { 'T', 'C', 'I', 'M', 'A', 'G', 'E', '\0' };
+    constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    template <typename T, typename Id>
+    void CheckIds(ArrayView<T> ids, Id limit, const char* message) {
+        for (const T id : ids) {
+            CheckImage(id < limit, message);
+        }
+    }
+
+}  // namespace
+
+struct CatalogueImage::Header {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t byte_order;
+    uint64_t file_size;
+    uint64_t stop_count;
+    uint64_t bus_count;
+    uint64_t distance_count;
+    double bus_wait_time;
+    double bus_velocity;
+    uint32_t router_type;
+    uint32_t router_compact_table;
+    uint64_t router_thread_count;
+    ImageSection sections[SECTION_COUNT];
+};
+
+std::shared_ptr<const CatalogueImage> CatalogueImage::Open(const std::string& path) {
+    std::shared_ptr<CatalogueImage> image(new CatalogueImage(path));
+    image->Validate();
+    return image;
+}
+
+CatalogueImage::CatalogueImage(const std::string& path)
+    : file_(path) {
+}
+
+const CatalogueImage::Header& CatalogueImage::GetHeader() const {
+    return *reinterpret_cast<const Header*>(file_.GetData());
+}
+
+template <typename T>
+ArrayView<T> CatalogueImage::GetSection(size_t section) const {
+    return GetImageSection<T>(file_.GetData(), GetHeader().sections[section]);
+}
+
+template <typename T>
+ArrayView<T> CatalogueImage::GetSlice(size_t offsets_section, size_t values_section, size_t index) const {
+    const ArrayView<uint64_t> offsets = GetSection<uint64_t>(offsets_section);
+    const T* values = GetSection<T>(values_section).begin();
+    return { values + offsets[index], values + offsets[index + 1] };
+}
+
+std::string_view CatalogueImage::GetString(size_t offsets_section, size_t index) const {
+    const ArrayView<char> chars = GetSlice<char>(offsets_section, STRING_POOL, index);
+    return { chars.begin(), chars.size() };
+}
+
+void CatalogueImage::Validate() const {
+    const size_t size = file_.GetSize();
+    CheckImage(size >= sizeof(Header), "file is too short");
+    const Header& header = GetHeader();
+    CheckImage(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0, "wrong magic");
+    CheckImage(header.format_version == FORMAT_VERSION, "unsupported format version");
+    CheckImage(header.byte_order == BYTE_ORDER_MARK, "wrong byte order");
+    CheckImage(header.file_size == size, "file size mismatch");
+    CheckImage(header.stop_count < std::numeric_limits<StopId>::max()
+        && header.bus_count < std::numeric_limits<BusId>::max(), "too many records");
+    CheckImage(header.router_type <= static_cast<uint32_t>(RouterType::RAPTOR), "unknown router type");
+
+    for (size_t section = 0; section < SECTION_COUNT; ++section) {
+        CheckImageSection(header.sections[section], size, ELEMENT_SIZES[section]);
+    }
+
+    const auto check_count = [&header](size_t section, uint64_t count) {
+        CheckImage(header.sections[section].size / ELEMENT_SIZES[section] == count, "section length does not match record count");
+    };
+    //        ,       
+    const auto check_offsets = [this, &header](size_t offsets_section, size_t values_section) {
+        const ArrayView<uint64_t> offsets = GetSection<uint64_t>(offsets_section);
+        for (size_t i = 1; i < offsets.size(); ++i) {
+            CheckImage(offsets[i - 1] <= offsets[i], "offsets should not decrease");
+        }
+        CheckImage(offsets[offsets.size() - 1] <= header.sections[values_section].size / ELEMENT_SIZES[values_section],
+            "offset is out of section");
+    };
+
+    check_count(STOP_NAME_OFFSETS, header.stop_count + 1);
+    check_count(STOP_LATITUDES, header.stop_count);
+    check_count(STOP_LONGITUDES, header.stop_count);
+    check_count(STOP_BUS_OFFSETS, header.stop_count + 1);
+    check_count(BUS_NAME_OFFSETS, header.bus_count + 1);
+    check_count(BUS_STOP_OFFSETS, header.bus_count + 1);
+    check_count(BUS_ROUNDTRIP, header.bus_count);
+    check_count(BUS_FINAL_STOPS, header.bus_count);
+    check_count(BUS_DEPARTURE_OFFSETS, header.bus_count + 1);
+    check_count(BUS_UNIQUE_STOPS, header.bus_count);
+    check_count(BUS_LENGTHS, header.bus_count);
+    check_count(BUS_CURVATURES, header.bus_count);
+    //        ,   
+    check_count(BUS_PREFIX_DISTANCES, header.sections[BUS_STOPS].size / ELEMENT_SIZES[BUS_STOPS]);
+    check_count(STOP_NAME_INDEX, header.stop_count);
+    check_count(BUS_NAME_INDEX, header.bus_count);
+
+    check_offsets(STOP_NAME_OFFSETS, STRING_POOL);
+    check_offsets(BUS_NAME_OFFSETS, STRING_POOL);
+    check_offsets(STOP_BUS_OFFSETS, STOP_BUSES);
+    check_offsets(BUS_STOP_OFFSETS, BUS_STOPS);
+    check_offsets(BUS_DEPARTURE_OFFSETS, BUS_DEPARTURES);
+
+    CheckIds(GetSection<BusId>(STOP_BUSES), header.bus_count, "bus id is out of range");
+    CheckIds(GetSection<StopId>(BUS_STOPS), header.stop_count, "stop id is out of range");
+    CheckIds(GetSection<StopId>(BUS_FINAL_STOPS), header.stop_count, "stop id is out of range");
+    CheckIds(GetSection<StopId>(STOP_NAME_INDEX), header.stop_count, "stop id is out of range");
+    CheckIds(GetSection<BusId>(BUS_NAME_INDEX), header.bus_count, "bus id is out of range");
+
+    //     ,   -  
+    const auto check_name_index = [this](size_t index_section, size_t offsets_section) {
+        const ArrayView<uint32_t> index = GetSection<uint32_t>(index_section);
+        for (size_t i = 1; i < index.size(); ++i) {
+            CheckImage(GetString(offsets_section, index[i - 1]) < GetString(offsets_section, index[i]),
+                "name index is not sorted");
+        }
+    };
+    check_name_index(STOP_NAME_INDEX, STOP_NAME_OFFSETS);
+    check_name_index(BUS_NAME_INDEX, BUS_NAME_OFFSETS);
+
+    //   DistanceIndex  :  ,     
+    const ArrayView<uint64_t> keys = GetSection<uint64_t>(DISTANCE_SLOT_KEYS);
+    CheckImage(GetSection<int32_t>(DISTANCE_SLOT_METERS).size() == keys.size(), "distance slot arrays differ in length");
+    CheckImage((keys.size() & (keys.size() - 1)) == 0, "distance slot count is not a power of two");
+    CheckImage(header.distance_count * 2 <= keys.size(), "distance slots are too full");
+    uint64_t occupied = 0;
+    for (const uint64_t key : keys) {
+        if (key != DistanceIndex::EMPTY_KEY) {
+            CheckImage(DistanceIndex::GetKeyFrom(key) < header.stop_count && DistanceIndex::GetKeyTo(key) < header.stop_count,
+                "stop id is out of range");
+            ++occupied;
+        }
+    }
+    CheckImage(occupied == header.distance_count, "distance count does not match the slots");
+}
+
+size_t CatalogueImage::GetStopCount() const {
+    return static_cast<size_t>(GetHeader().stop_count);
+}
+
+size_t CatalogueImage::GetBusCount() const {
+    return static_cast<size_t>(GetHeader().bus_count);
+}
+
+size_t CatalogueImage::GetDistanceCount() const {
+    return static_cast<size_t>(GetHeader().distance_count);
+}
+
+RoutingSettings CatalogueImage::GetRoutingSettings() const {
+    const Header& header = GetHeader();
+    RoutingSettings settings(header.bus_wait_time, header.bus_velocity);
+    settings.router_type = static_cast<RouterType>(header.router_type);
+    settings.router_thread_count = static_cast<size_t>(header.router_thread_count);
+    settings.router_compact_table = header.router_compact_table != 0;
+    return settings;
+}
+
+std::string_view CatalogueImage::GetStopName(StopId id) const {
+    return GetString(STOP_NAME_OFFSETS, id);
+}
+
+geo::Coordinates CatalogueImage::GetStopCoordinates(StopId id) const {
+    return { GetSection<double>(STOP_LATITUDES)[id], GetSection<double>(STOP_LONGITUDES)[id] };
+}
+
+ArrayView<BusId> CatalogueImage::GetStopBuses(StopId id) const {
+    return GetSlice<BusId>(STOP_BUS_OFFSETS, STOP_BUSES, id);
+}
+
+std::string_view CatalogueImage::GetBusName(BusId id) const {
+    return GetString(BUS_NAME_OFFSETS, id);
+}
+
+ArrayView<StopId> CatalogueImage::GetBusStops(BusId id) const {
+    return GetSlice<StopId>(BUS_STOP_OFFSETS, BUS_STOPS, id);
+}
+
+TypeRoute CatalogueImage::GetBusRouteType(BusId id) const {
+    return { GetSection<uint32_t>(BUS_ROUNDTRIP)[id] != 0, GetSection<StopId>(BUS_FINAL_STOPS)[id] };
+}
+
+ArrayView<double> CatalogueImage::GetBusDepartures(BusId id) const {
+    return GetSlice<double>(BUS_DEPARTURE_OFFSETS, BUS_DEPARTURES, id);
+}
+
+BusStat CatalogueImage::GetBusStat(BusId id) const {
+    return { GetBusStops(id).size(), static_cast<size_t>(GetSection<uint64_t>(BUS_UNIQUE_STOPS)[id]),
+        GetSection<double>(BUS_LENGTHS)[id], GetSection<double>(BUS_CURVATURES)[id] };
+}
+
+ArrayView<double> CatalogueImage::GetBusPrefixDistances(BusId id) const {
+    return GetSlice<double>(BUS_STOP_OFFSETS, BUS_PREFIX_DISTANCES, id);
+}
+
+std::optional<StopId> CatalogueImage::FindStop(std::string_view name) const {
+    return FindByName(STOP_NAME_INDEX, STOP_NAME_OFFSETS, name);
+}
+
+std::optional<BusId> CatalogueImage::FindBus(std::string_view name) const {
+    return FindByName(BUS_NAME_INDEX, BUS_NAME_OFFSETS, name);
+}
+
+std::optional<uint32_t> CatalogueImage::FindByName(size_t index_section, size_t offsets_section, std::string_view name) const {
+    const ArrayView<uint32_t> index = GetSection<uint32_t>(index_section);
+    const uint32_t* it = std::lower_bound(index.begin(), index.end(), name,
+        [this, offsets_section](uint32_t id, std::string_view value) { return GetString(offsets_section, id) < value; });
+    if (it != index.end() && GetString(offsets_section, *it) == name) {
+        return *it;
+    }
+    return std::nullopt;
+}
+
+ArrayView<uint64_t> CatalogueImage::GetDistanceSlotKeys() const {
+    return GetSection<uint64_t>(DISTANCE_SLOT_KEYS);
+}
+
+ArrayView<int32_t> CatalogueImage::GetDistanceSlotMeters() const {
+    return GetSection<int32_t>(DISTANCE_SLOT_METERS);
+}
+
+void WriteCatalogueImage(const TransportCatalogue& catalogue, const RoutingSettings& settings, std::ostream& output) {
+    const size_t stop_count = catalogue.GetAllStopsCount();
+    const size_t bus_count = catalogue.GetAllBuses().size();
+
+    std::vector<char> pool;
+    std::vector<uint64_t> stop_name_offsets{ 0 }, bus_name_offsets{ 0 };
+    std::vector<double> latitudes, longitudes;
+    std::vector<uint64_t> stop_bus_offsets{ 0 };
+    std::vector<BusId> stop_buses;
+    for (StopId id = 0; id < stop_count; ++id) {
+        const Stop& stop = catalogue.GetStop(id);
+        pool.insert(pool.end(), stop.stop_name.begin(), stop.stop_name.end());
+        stop_name_offsets.push_back(pool.size());
+        latitudes.push_back(stop.coordinates.lat);
+        longitudes.push_back(stop.coordinates.lng);
+        for (const std::string_view bus_name : catalogue.GetStopBuses(id)) {
+            stop_buses.push_back(catalogue.FindBus(bus_name)->id);
+        }
+        stop_bus_offsets.push_back(stop_buses.size());
+    }
+
+    std::vector<uint64_t> bus_stop_offsets{ 0 }, departure_offsets{ 0 };
+    std::vector<StopId> bus_stops, final_stops;
+    std::vector<uint32_t> roundtrip;
+    std::vector<double> departures;
+    std::vector<uint64_t> unique_stops;
+    std::vector<double> lengths, curvatures, prefix_distances;
+    for (const Bus& bus : catalogue.GetAllBuses()) {
+        pool.insert(pool.end(), bus.bus_name.begin(), bus.bus_name.end());
+        //         
+        bus_name_offsets.push_back(pool.size());
+        bus_stops.insert(bus_stops.end(), bus.stops.begin(), bus.stops.end());
+        bus_stop_offsets.push_back(bus_stops.size());
+        roundtrip.push_back(bus.is_roundtrip.first ? 1 : 0);
+        final_stops.push_back(bus.is_roundtrip.second);
+        departures.insert(departures.end(), bus.departures.begin(), bus.departures.end());
+        departure_offsets.push_back(departures.size());
+        const BusStat& stat = catalogue.GetBusStat(bus.id);
+        unique_stops.push_back(stat.unique_stops);
+        lengths.push_back(stat.length);
+        curvatures.push_back(stat.curvature);
+        const ArrayView<double> prefix = catalogue.GetBusPrefixDistances(bus.id);
+        prefix_distances.insert(prefix_distances.end(), prefix.begin(), prefix.end());
+    }
+    bus_name_offsets.front() = stop_name_offsets.back();
+
+    //      -    ,   
+    std::vector<StopId> stop_name_index(stop_count);
+    std::iota(stop_name_index.begin(), stop_name_index.end(), 0);
+    std::sort(stop_name_index.begin(), stop_name_index.end(), [&catalogue](StopId lhs, StopId rhs) {
+        return catalogue.GetStop(lhs).stop_name < catalogue.GetStop(rhs).stop_name;
+        });
+    std::vector<BusId> bus_name_index(bus_count);
+    std::iota(bus_name_index.begin(), bus_name_index.end(), 0);
+    std::sort(bus_name_index.begin(), bus_name_index.end(), [&catalogue](BusId lhs, BusId rhs) {
+        return catalogue.GetBus(lhs).bus_name < catalogue.GetBus(rhs).bus_name;
+        });
+
+    //            
+    const DistanceIndex& distances = catalogue.GetDistanceIndex();
+
+    ImageLayout layout(sizeof(CatalogueImage::Header));
+    layout.AddSection(pool);
+    layout.AddSection(stop_name_offsets);
+    layout.AddSection(latitudes);
+    layout.AddSection(longitudes);
+    layout.AddSection(stop_bus_offsets);
+    layout.AddSection(stop_buses);
+    layout.AddSection(bus_name_offsets);
+    layout.AddSection(bus_stop_offsets);
+    layout.AddSection(bus_stops);
+    layout.AddSection(roundtrip);
+    layout.AddSection(final_stops);
+    layout.AddSection(departure_offsets);
+    layout.AddSection(departures);
+    layout.AddSection(unique_stops);
+    layout.AddSection(lengths);
+    layout.AddSection(curvatures);
+    layout.AddSection(prefix_distances);
+    layout.AddSection(stop_name_index);
+    layout.AddSection(bus_name_index);
+    layout.AddSection(distances.GetSlotKeys());
+    layout.AddSection(distances.GetSlotMeters());
+
+    CatalogueImage::Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.format_version = CatalogueImage::FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.file_size = layout.GetSize();
+    header.stop_count = stop_count;
+    header.bus_count = bus_count;
+    header.distance_count = distances.GetSize();
+    header.bus_wait_time = settings.bus_wait_time;
+    header.bus_velocity = settings.bus_velocity;
+    header.router_type = static_cast<uint32_t>(settings.router_type);
+    header.router_compact_table = settings.router_compact_table ? 1 : 0;
+    header.router_thread_count = settings.router_thread_count;
+    std::copy(layout.GetSections().begin(), layout.GetSections().end(), header.sections);
+    layout.Write(output, &header);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "domain.h"
+#include "mapped_file.h"
+
+class TransportCatalogue;
+
+//   .   -   ImageSection;   
+//     count + 1.       
+class CatalogueImage {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 3;
+
+    //  std::runtime_error,          .
+    //    MappedFile,       
+    static std::shared_ptr<const CatalogueImage> Open(const std::string& path);
+
+
+    size_t GetStopCount() const;
+    size_t GetBusCount() const;
+    size_t GetDistanceCount() const;
+    RoutingSettings GetRoutingSettings() const;
+
+    std::string_view GetStopName(StopId id) const;
+    geo::Coordinates GetStopCoordinates(StopId id) const;
+    //      
+    ArrayView<BusId> GetStopBuses(StopId id) const;
+
+    std::string_view GetBusName(BusId id) const;
+    //       ,   Bus::stops
+    ArrayView<StopId> GetBusStops(BusId id) const;
+    TypeRoute GetBusRouteType(BusId id) const;
+    ArrayView<double> GetBusDepartures(BusId id) const;
+    //    ,     
+    BusStat GetBusStat(BusId id) const;
+    ArrayView<double> GetBusPrefixDistances(BusId id) const;
+
+    //     ,   
+    std::optional<StopId> FindStop(std::string_view name) const;
+    std::optional<BusId> FindBus(std::string_view name) const;
+
+    //  DistanceIndex   ,     , . DistanceIndex::Attach
+    ArrayView<uint64_t> GetDistanceSlotKeys() const;
+    ArrayView<int32_t> GetDistanceSlotMeters() const;
+
+private:
+    struct Header;
+    friend void WriteCatalogueImage(const TransportCatalogue& catalogue, const RoutingSettings& settings, std::ostream& output);
+
+    explicit CatalogueImage(const std::string& path);
+    void Validate() const;
+    const Header& GetHeader() const;
+    template <typename T>
+    ArrayView<T> GetSection(size_t section) const;
+    template <typename T>
+    ArrayView<T> GetSlice(size_t offsets_section, size_t values_section, size_t index) const;
+    std::string_view GetString(size_t offsets_section, size_t index) const;
+    std::optional<uint32_t> FindByName(size_t index_section, size_t offsets_section, std::string_view name) const;
+
+    MappedFile file_;
+};
+
+//        
+void WriteCatalogueImage(const TransportCatalogue& catalogue, const RoutingSettings& settings, std::ostream& output);
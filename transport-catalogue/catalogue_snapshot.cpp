@@ -0,0 +1,180 @@
+#include "catalogue_snapshot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+void NetworkDescription::SetStop(std::string name, geo::Coordinates coordinates) {
+    auto it = std::find_if(stops.begin(), stops.end(), [&name](const StopDescription& stop) {
+        return stop.name == name;
+        });
+    if (it != stops.end()) {
+        it->coordinates = coordinates;
+    }
+    else {
+        stops.push_back({ std::move(name), coordinates });
+    }
+}
+
+void NetworkDescription::SetDistance(std::string from, std::string to, int meters) {
+    auto it = std::find_if(distances.begin(), distances.end(), [&from, &to](const DistanceDescription& distance) {
+        return distance.from == from && distance.to == to;
+        });
+    if (it != distances.end()) {
+        it->meters = meters;
+    }
+    else {
+        distances.push_back({ std::move(from), std::move(to), meters });
+    }
+}
+
+void NetworkDescription::SetBus(BusDescription bus) {
+    auto it = std::find_if(buses.begin(), buses.end(), [&bus](const BusDescription& other) {
+        return other.name == bus.name;
+        });
+    if (it != buses.end()) {
+        *it = std::move(bus);
+    }
+    else {
+        buses.push_back(std::move(bus));
+    }
+}
+
+void NetworkDescription::Validate() const {
+    std::unordered_set<std::string_view> stop_names;
+    for (const StopDescription& stop : stops) {
+        stop_names.insert(stop.name);
+    }
+    for (const DistanceDescription& distance : distances) {
+        if (!stop_names.count(distance.from)) {
+            throw std::invalid_argument("Road distance from unknown stop " + distance.from);
+        }
+    }
+    for (const BusDescription& bus : buses) {
+        if (bus.stops.empty()) {
+            throw std::invalid_argument("Bus " + bus.name + " has no stops");
+        }
+        for (const std::string& stop : bus.stops) {
+            if (!stop_names.count(stop)) {
+                throw std::invalid_argument("Bus " + bus.name + " refers to unknown stop " + stop);
+            }
+        }
+    }
+}
+
+CatalogueSnapshot::CatalogueSnapshot(const NetworkDescription& network, uint64_t version)
+    : version_(version)
+    , router_(catalogue_) {
+    network.Validate();
+    for (const StopDescription& stop : network.stops) {
+        catalogue_.AddStop(stop.name, stop.coordinates);
+    }
+    for (const DistanceDescription& distance : network.distances) {
+        catalogue_.SetDistanceBetweenStops(distance.from, distance.to, Distance(distance.meters));
+    }
+    for (const BusDescription& bus : network.buses) {
+        TypeRoute type = { bus.is_roundtrip, catalogue_.FindStop(bus.stops.back())->id };
+        std::vector<std::string> stops = bus.stops;
+        if (!bus.is_roundtrip) {
+            stops.insert(stops.end(), std::next(bus.stops.rbegin()), bus.stops.rend());
+        }
+        catalogue_.AddBus(bus.name, stops, type);
+        catalogue_.SetBusDepartures(bus.name, bus.departures);
+    }
+    catalogue_.Finalize();
+    router_.SetRoutingSettings(network.routing_settings);
+}
+
+CatalogueSnapshot::CatalogueSnapshot(std::shared_ptr<const CatalogueImage> image, uint64_t version,
+    std::shared_ptr<const RoutingImage> routing_image)
+    : version_(version)
+    , image_(std::move(image))
+    , router_(catalogue_) {
+    catalogue_.LoadImage(*image_);
+    router_.SetRoutingSettings(image_->GetRoutingSettings());
+    if (routing_image) {
+        router_.SetRoutingImage(std::move(routing_image));
+    }
+}
+
+uint64_t CatalogueSnapshot::GetVersion() const {
+    return version_;
+}
+
+NetworkDescription CatalogueSnapshot::GetNetwork() const {
+    NetworkDescription network;
+    for (StopId id = 0; id < catalogue_.GetAllStopsCount(); ++id) {
+        const Stop& stop = catalogue_.GetStop(id);
+        network.stops.push_back({ std::string(stop.stop_name), stop.coordinates });
+    }
+    catalogue_.ForEachDistance([this, &network](StopId from, StopId to, int meters) {
+        network.distances.push_back({ std::string(catalogue_.GetStop(from).stop_name),
+            std::string(catalogue_.GetStop(to).stop_name), meters });
+        });
+    for (const Bus& bus : catalogue_.GetAllBuses()) {
+        BusDescription description;
+        description.name = bus.bus_name;
+        description.is_roundtrip = bus.is_roundtrip.first;
+        //       
+        const size_t forward_count = bus.is_roundtrip.first ? bus.stops.size() : (bus.stops.size() + 1) / 2;
+        for (size_t i = 0; i < forward_count; ++i) {
+            description.stops.emplace_back(catalogue_.GetStop(bus.stops[i]).stop_name);
+        }
+        description.departures.assign(bus.departures.begin(), bus.departures.end());
+        network.buses.push_back(std::move(description));
+    }
+    network.routing_settings = router_.GetRoutingSettings();
+    return network;
+}
+
+const TransportCatalogue& CatalogueSnapshot::GetCatalogue() const {
+    return catalogue_;
+}
+
+const transport_router::TransportRouter& CatalogueSnapshot::GetRouter() const {
+    router_.Build();
+    return router_;
+}
+
+SnapshotPtr SnapshotStore::GetSnapshot() const {
+    return std::atomic_load(&current_);
+}
+
+SnapshotPtr SnapshotStore::Publish(NetworkDescription network, bool build_router) {
+    std::lock_guard guard(writer_mutex_);
+    return PublishLocked(build_router, network);
+}
+
+SnapshotPtr SnapshotStore::Publish(std::shared_ptr<const CatalogueImage> image, bool build_router,
+    std::shared_ptr<const RoutingImage> routing_image) {
+    std::lock_guard guard(writer_mutex_);
+    return PublishLocked(build_router, image, routing_image);
+}
+
+SnapshotPtr SnapshotStore::Update(const std::function<void(NetworkDescription&)>& change, bool build_router) {
+    std::lock_guard guard(writer_mutex_);
+    NetworkDescription network = current_ ? current_->GetNetwork() : NetworkDescription{};
+    change(network);
+    return PublishLocked(build_router, network);
+}
+
+std::future<SnapshotPtr> SnapshotStore::UpdateAsync(std::function<void(NetworkDescription&)> change) {
+    return std::async(std::launch::async, [this, change = std::move(change)] {
+        return Update(change);
+        });
+}
+
+template <typename Source, typename... Args>
+SnapshotPtr SnapshotStore::PublishLocked(bool build_router, const Source& source, const Args&... args) {
+    // current_     writer_mutex_,       atomic_load
+    const uint64_t version = current_ ? current_->GetVersion() + 1 : 1;
+    auto snapshot = std::make_shared<const CatalogueSnapshot>(source, version, args...);
+    if (build_router) {
+        snapshot->GetRouter();
+    }
+    std::atomic_store(&current_, SnapshotPtr(snapshot));
+    return snapshot;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "catalogue_image.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+struct StopDescription {
+    std::string name;
+    geo::Coordinates coordinates;
+};
+
+struct DistanceDescription {
+    std::string from;
+    std::string to;
+    int meters;
+};
+
+struct BusDescription {
+    std::string name;
+    std::vector<std::string> stops;  //    -   
+    bool is_roundtrip = false;
+    std::vector<double> departures;
+};
+
+//     ,    .   :
+//      
+struct NetworkDescription {
+    std::vector<StopDescription> stops;
+    std::vector<DistanceDescription> distances;
+    std::vector<BusDescription> buses;
+    RoutingSettings routing_settings;
+
+    //            
+    void SetStop(std::string name, geo::Coordinates coordinates);
+    void SetDistance(std::string from, std::string to, int meters);
+    void SetBus(BusDescription bus);
+
+    //  std::invalid_argument,        
+    //      
+    void Validate() const;
+};
+
+//   :     .     ,
+//     string_view   ,   -   
+class CatalogueSnapshot {
+public:
+    //   - std::invalid_argument, . NetworkDescription::Validate
+    CatalogueSnapshot(const NetworkDescription& network, uint64_t version);
+    //     ,   ,   .
+    // routing_image        , . TransportRouter::SetRoutingImage
+    CatalogueSnapshot(std::shared_ptr<const CatalogueImage> image, uint64_t version,
+        std::shared_ptr<const RoutingImage> routing_image = nullptr);
+    CatalogueSnapshot(const CatalogueSnapshot&) = delete;
+    CatalogueSnapshot& operator=(const CatalogueSnapshot&) = delete;
+
+    uint64_t GetVersion() const;
+    //    :       
+    NetworkDescription GetNetwork() const;
+    const TransportCatalogue& GetCatalogue() const;
+    //     ; TransportRouter::Build() 
+    const transport_router::TransportRouter& GetRouter() const;
+
+private:
+    const uint64_t version_;
+    std::shared_ptr<const CatalogueImage> image_;  //   ,   
+    TransportCatalogue catalogue_;
+    mutable transport_router::TransportRouter router_;
+};
+
+using SnapshotPtr = std::shared_ptr<const CatalogueSnapshot>;
+
+//   .           ;
+//           
+class SnapshotStore {
+public:
+    // nullptr   
+    SnapshotPtr GetSnapshot() const;
+
+    //        . build_router == false 
+    //      
+    SnapshotPtr Publish(NetworkDescription network, bool build_router = true);
+    SnapshotPtr Publish(std::shared_ptr<const CatalogueImage> image, bool build_router = true,
+        std::shared_ptr<const RoutingImage> routing_image = nullptr);
+    //       
+    SnapshotPtr Update(const std::function<void(NetworkDescription&)>& change, bool build_router = true);
+    //     
+    std::future<SnapshotPtr> UpdateAsync(std::function<void(NetworkDescription&)> change);
+
+private:
+    //   source       
+    template <typename Source, typename... Args>
+    SnapshotPtr PublishLocked(bool build_router, const Source& source, const Args&... args);
+
+    std::mutex writer_mutex_;  //  ;    
+    SnapshotPtr current_;
+};
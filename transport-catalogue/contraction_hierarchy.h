@@ -0,0 +1,449 @@
+#pragma once
+
+#include "array_view.h"
+#include "router.h"
+#include "search_workspace.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace graph {
+
+    template <typename Weight>
+    class ContractionHierarchy : public RouteBuilder<Weight> {
+    private:
+        using Graph = DirectedWeightedGraph<Weight>;
+
+    public:
+        using typename RouteBuilder<Weight>::RouteInfo;
+
+        //    :   (  ),  
+        //     -    -   CSR
+        struct HierarchyData {
+            ArrayView<uint32_t> edge_from;
+            ArrayView<uint32_t> edge_to;
+            ArrayView<Weight> edge_weight;
+            // EdgeId  ,   - NO_EDGE
+            ArrayView<uint32_t> edge_original;
+            // и,   ,    - NO_EDGE
+            ArrayView<uint32_t> edge_first_child;
+            ArrayView<uint32_t> edge_second_child;
+            ArrayView<uint32_t> ranks;
+            ArrayView<uint32_t> upward_offsets;
+            ArrayView<uint32_t> upward_edges;
+            ArrayView<uint32_t> downward_offsets;
+            ArrayView<uint32_t> downward_edges;
+        };
+
+        static constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+
+        explicit ContractionHierarchy(const Graph& graph);
+        //      .        
+        explicit ContractionHierarchy(const HierarchyData& data);
+        ContractionHierarchy(const ContractionHierarchy&) = delete;
+        ContractionHierarchy& operator=(const ContractionHierarchy&) = delete;
+
+        const HierarchyData& GetData() const {
+            return data_;
+        }
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+
+    private:
+        struct HierarchyEdge {
+            VertexId from;
+            VertexId to;
+            Weight weight;
+            EdgeId original_edge;
+            size_t first_child;
+            size_t second_child;
+        };
+
+        struct QueueItem {
+            Weight weight;
+            VertexId vertex;
+
+            bool operator>(const QueueItem& other) const {
+                return weight > other.weight;
+            }
+        };
+        using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+        struct ContractionState {
+            explicit ContractionState(size_t vertex_count)
+                : outgoing(vertex_count)
+                , incoming(vertex_count)
+                , contracted(vertex_count, false)
+                , contracted_neighbors(vertex_count, 0)
+                , witness_weights(vertex_count)
+                , witness_stamps(vertex_count, 0) {
+            }
+
+            std::vector<HierarchyEdge> edges;
+            std::vector<std::vector<size_t>> outgoing;
+            std::vector<std::vector<size_t>> incoming;
+            std::vector<bool> contracted;
+            std::vector<int> contracted_neighbors;
+            std::vector<Weight> witness_weights;
+            std::vector<size_t> witness_stamps;
+            size_t witness_stamp = 0;
+        };
+
+        struct HierarchyStorage {
+            std::vector<uint32_t> edge_from;
+            std::vector<uint32_t> edge_to;
+            std::vector<Weight> edge_weight;
+            std::vector<uint32_t> edge_original;
+            std::vector<uint32_t> edge_first_child;
+            std::vector<uint32_t> edge_second_child;
+            std::vector<uint32_t> ranks;
+            std::vector<uint32_t> upward_offsets;
+            std::vector<uint32_t> upward_edges;
+            std::vector<uint32_t> downward_offsets;
+            std::vector<uint32_t> downward_edges;
+        };
+
+        struct SearchSide {
+            explicit SearchSide(SearchWorkspace<Weight>& workspace)
+                : workspace(workspace) {
+            }
+
+            SearchWorkspace<Weight>& workspace;
+            Queue queue;
+
+            std::optional<Weight> GetTopWeight() {
+                while (!queue.empty() && queue.top().weight > workspace.GetWeight(queue.top().vertex)) {
+                    queue.pop();
+                }
+                if (queue.empty()) {
+                    return std::nullopt;
+                }
+                return queue.top().weight;
+            }
+        };
+
+        void AddHierarchyEdge(ContractionState& state, const HierarchyEdge& edge) {
+            state.outgoing[edge.from].push_back(state.edges.size());
+            state.incoming[edge.to].push_back(state.edges.size());
+            state.edges.push_back(edge);
+        }
+
+        void RunWitnessSearch(ContractionState& state, VertexId source, VertexId excluded, Weight max_weight) const {
+            ++state.witness_stamp;
+            Queue queue;
+            state.witness_weights[source] = ZERO_WEIGHT;
+            state.witness_stamps[source] = state.witness_stamp;
+            queue.push({ ZERO_WEIGHT, source });
+
+            size_t settled_count = 0;
+            while (!queue.empty() && settled_count < WITNESS_SETTLE_LIMIT) {
+                const QueueItem item = queue.top();
+                queue.pop();
+                if (item.weight > state.witness_weights[item.vertex]) {
+                    continue;
+                }
+                if (item.weight > max_weight) {
+                    break;
+                }
+                ++settled_count;
+                for (const size_t edge_index : state.outgoing[item.vertex]) {
+                    const HierarchyEdge& edge = state.edges[edge_index];
+                    if (edge.to == excluded || state.contracted[edge.to]) {
+                        continue;
+                    }
+                    const Weight candidate_weight = item.weight + edge.weight;
+                    if (state.witness_stamps[edge.to] != state.witness_stamp
+                        || candidate_weight < state.witness_weights[edge.to]) {
+                        state.witness_weights[edge.to] = candidate_weight;
+                        state.witness_stamps[edge.to] = state.witness_stamp;
+                        queue.push({ candidate_weight, edge.to });
+                    }
+                }
+            }
+        }
+
+        std::vector<HierarchyEdge> FindShortcuts(ContractionState& state, VertexId vertex) const {
+            std::vector<HierarchyEdge> shortcuts;
+            for (const size_t in_index : state.incoming[vertex]) {
+                const HierarchyEdge& in_edge = state.edges[in_index];
+                if (state.contracted[in_edge.from] || in_edge.from == vertex) {
+                    continue;
+                }
+                Weight max_weight = ZERO_WEIGHT;
+                bool has_targets = false;
+                for (const size_t out_index : state.outgoing[vertex]) {
+                    const HierarchyEdge& out_edge = state.edges[out_index];
+                    if (!state.contracted[out_edge.to] && out_edge.to != in_edge.from && out_edge.to != vertex) {
+                        max_weight = std::max(max_weight, in_edge.weight + out_edge.weight);
+                        has_targets = true;
+                    }
+                }
+                if (!has_targets) {
+                    continue;
+                }
+
+                RunWitnessSearch(state, in_edge.from, vertex, max_weight);
+                for (const size_t out_index : state.outgoing[vertex]) {
+                    const HierarchyEdge& out_edge = state.edges[out_index];
+                    if (state.contracted[out_edge.to] || out_edge.to == in_edge.from || out_edge.to == vertex) {
+                        continue;
+                    }
+                    const Weight shortcut_weight = in_edge.weight + out_edge.weight;
+                    if (state.witness_stamps[out_edge.to] == state.witness_stamp
+                        && state.witness_weights[out_edge.to] <= shortcut_weight) {
+                        continue;
+                    }
+                    shortcuts.push_back({ in_edge.from, out_edge.to, shortcut_weight, NO_EDGE, in_index, out_index });
+                }
+            }
+
+            std::sort(shortcuts.begin(), shortcuts.end(), [](const HierarchyEdge& lhs, const HierarchyEdge& rhs) {
+                return std::tie(lhs.from, lhs.to, lhs.weight) < std::tie(rhs.from, rhs.to, rhs.weight);
+                });
+            shortcuts.erase(std::unique(shortcuts.begin(), shortcuts.end(), [](const HierarchyEdge& lhs, const HierarchyEdge& rhs) {
+                return lhs.from == rhs.from && lhs.to == rhs.to;
+                }), shortcuts.end());
+            return shortcuts;
+        }
+
+        int ComputePriority(const ContractionState& state, VertexId vertex, size_t shortcut_count) const {
+            int removed_count = 0;
+            for (const size_t edge_index : state.incoming[vertex]) {
+                removed_count += state.contracted[state.edges[edge_index].from] ? 0 : 1;
+            }
+            for (const size_t edge_index : state.outgoing[vertex]) {
+                removed_count += state.contracted[state.edges[edge_index].to] ? 0 : 1;
+            }
+            return static_cast<int>(shortcut_count) - removed_count + state.contracted_neighbors[vertex];
+        }
+
+        void Contract(const Graph& graph, ContractionState& state) {
+            const size_t vertex_count = graph.GetVertexCount();
+
+            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+                std::vector<HierarchyEdge> edges;
+                graph.ForEachIncidentEdge(vertex, [&](EdgeId edge_id, VertexId vertex_to, Weight edge_weight) {
+                    if (edge_weight < ZERO_WEIGHT) {
+                        throw std::domain_error("Edges' weights should be non-negative");
+                    }
+                    if (vertex_to != vertex) {
+                        edges.push_back({ vertex, vertex_to, edge_weight, edge_id, NO_EDGE, NO_EDGE });
+                    }
+                    });
+                std::stable_sort(edges.begin(), edges.end(), [](const HierarchyEdge& lhs, const HierarchyEdge& rhs) {
+                    return std::tie(lhs.to, lhs.weight) < std::tie(rhs.to, rhs.weight);
+                    });
+                for (size_t i = 0; i < edges.size(); ++i) {
+                    if (i == 0 || edges[i].to != edges[i - 1].to) {
+                        AddHierarchyEdge(state, edges[i]);
+                    }
+                }
+            }
+
+            using PriorityItem = std::pair<int, VertexId>;
+            std::priority_queue<PriorityItem, std::vector<PriorityItem>, std::greater<PriorityItem>> order;
+            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+                order.push({ ComputePriority(state, vertex, FindShortcuts(state, vertex).size()), vertex });
+            }
+
+            storage_.ranks.assign(vertex_count, 0);
+            uint32_t rank = 0;
+            while (!order.empty()) {
+                const VertexId vertex = order.top().second;
+                order.pop();
+                if (state.contracted[vertex]) {
+                    continue;
+                }
+                std::vector<HierarchyEdge> shortcuts = FindShortcuts(state, vertex);
+                const int priority = ComputePriority(state, vertex, shortcuts.size());
+                if (!order.empty() && priority > order.top().first) {
+                    order.push({ priority, vertex });
+                    continue;
+                }
+
+                for (const HierarchyEdge& shortcut : shortcuts) {
+                    AddHierarchyEdge(state, shortcut);
+                }
+                state.contracted[vertex] = true;
+                storage_.ranks[vertex] = rank++;
+                for (const size_t edge_index : state.incoming[vertex]) {
+                    ++state.contracted_neighbors[state.edges[edge_index].from];
+                }
+                for (const size_t edge_index : state.outgoing[vertex]) {
+                    ++state.contracted_neighbors[state.edges[edge_index].to];
+                }
+            }
+        }
+
+        void StoreEdges(const std::vector<HierarchyEdge>& edges) {
+            if (edges.size() >= NO_EDGE) {
+                throw std::length_error("Contraction hierarchy has too many edges");
+            }
+            storage_.edge_from.reserve(edges.size());
+            storage_.edge_to.reserve(edges.size());
+            storage_.edge_weight.reserve(edges.size());
+            storage_.edge_original.reserve(edges.size());
+            storage_.edge_first_child.reserve(edges.size());
+            storage_.edge_second_child.reserve(edges.size());
+            for (const HierarchyEdge& edge : edges) {
+                storage_.edge_from.push_back(edge.from);
+                storage_.edge_to.push_back(edge.to);
+                storage_.edge_weight.push_back(edge.weight);
+                storage_.edge_original.push_back(edge.original_edge);
+                storage_.edge_first_child.push_back(static_cast<uint32_t>(edge.first_child));
+                storage_.edge_second_child.push_back(static_cast<uint32_t>(edge.second_child));
+            }
+        }
+
+        void BuildUpwardGraphs(size_t vertex_count) {
+            const std::vector<uint32_t>& ranks = storage_.ranks;
+            std::vector<uint32_t>& upward_offsets = storage_.upward_offsets;
+            std::vector<uint32_t>& downward_offsets = storage_.downward_offsets;
+            const size_t edge_count = storage_.edge_from.size();
+            upward_offsets.assign(vertex_count + 1, 0);
+            downward_offsets.assign(vertex_count + 1, 0);
+            for (size_t edge_index = 0; edge_index < edge_count; ++edge_index) {
+                const VertexId from = storage_.edge_from[edge_index];
+                const VertexId to = storage_.edge_to[edge_index];
+                if (ranks[from] < ranks[to]) {
+                    ++upward_offsets[from + 1];
+                }
+                else {
+                    ++downward_offsets[to + 1];
+                }
+            }
+            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+                upward_offsets[vertex + 1] += upward_offsets[vertex];
+                downward_offsets[vertex + 1] += downward_offsets[vertex];
+            }
+
+            storage_.upward_edges.resize(upward_offsets.back());
+            storage_.downward_edges.resize(downward_offsets.back());
+            std::vector<uint32_t> upward_positions(upward_offsets.begin(), upward_offsets.end() - 1);
+            std::vector<uint32_t> downward_positions(downward_offsets.begin(), downward_offsets.end() - 1);
+            for (size_t edge_index = 0; edge_index < edge_count; ++edge_index) {
+                const VertexId from = storage_.edge_from[edge_index];
+                const VertexId to = storage_.edge_to[edge_index];
+                if (ranks[from] < ranks[to]) {
+                    storage_.upward_edges[upward_positions[from]++] = static_cast<uint32_t>(edge_index);
+                }
+                else {
+                    storage_.downward_edges[downward_positions[to]++] = static_cast<uint32_t>(edge_index);
+                }
+            }
+        }
+
+        void UnpackEdge(uint32_t edge_index, std::vector<EdgeId>& edges) const {
+            std::vector<uint32_t> stack{ edge_index };
+            while (!stack.empty()) {
+                const uint32_t edge = stack.back();
+                stack.pop_back();
+                if (data_.edge_original[edge] != NO_EDGE) {
+                    edges.push_back(data_.edge_original[edge]);
+                }
+                else {
+                    stack.push_back(data_.edge_second_child[edge]);
+                    stack.push_back(data_.edge_first_child[edge]);
+                }
+            }
+        }
+
+        static constexpr Weight ZERO_WEIGHT{};
+        static constexpr size_t WITNESS_SETTLE_LIMIT = 500;
+        // ,      
+        HierarchyStorage storage_;
+        HierarchyData data_;
+    };
+
+    template <typename Weight>
+    ContractionHierarchy<Weight>::ContractionHierarchy(const Graph& graph) {
+        ContractionState state(graph.GetVertexCount());
+        Contract(graph, state);
+        StoreEdges(state.edges);
+        BuildUpwardGraphs(graph.GetVertexCount());
+        data_ = { storage_.edge_from, storage_.edge_to, storage_.edge_weight, storage_.edge_original,
+            storage_.edge_first_child, storage_.edge_second_child, storage_.ranks,
+            storage_.upward_offsets, storage_.upward_edges, storage_.downward_offsets, storage_.downward_edges };
+    }
+
+    template <typename Weight>
+    ContractionHierarchy<Weight>::ContractionHierarchy(const HierarchyData& data)
+        : data_(data) {
+    }
+
+    template <typename Weight>
+    std::optional<typename ContractionHierarchy<Weight>::RouteInfo> ContractionHierarchy<Weight>::BuildRoute(VertexId from,
+        VertexId to) const {
+        const size_t vertex_count = data_.ranks.size();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+
+        SearchSide forward(GetThreadWorkspace<Weight>(0, vertex_count));
+        SearchSide backward(GetThreadWorkspace<Weight>(1, vertex_count));
+        forward.workspace.Reach(from, ZERO_WEIGHT, NO_EDGE);
+        forward.queue.push({ ZERO_WEIGHT, from });
+        backward.workspace.Reach(to, ZERO_WEIGHT, NO_EDGE);
+        backward.queue.push({ ZERO_WEIGHT, to });
+        std::optional<Weight> best_weight;
+        VertexId meeting_vertex = from;
+
+        while (true) {
+            const std::optional<Weight> forward_weight = forward.GetTopWeight();
+            const std::optional<Weight> backward_weight = backward.GetTopWeight();
+            const bool forward_step = forward_weight && (!backward_weight || *forward_weight <= *backward_weight);
+            const std::optional<Weight>& top_weight = forward_step ? forward_weight : backward_weight;
+            if (!top_weight || (best_weight && *top_weight >= *best_weight)) {
+                break;
+            }
+
+            SearchSide& side = forward_step ? forward : backward;
+            const SearchSide& other_side = forward_step ? backward : forward;
+            const ArrayView<uint32_t> offsets = forward_step ? data_.upward_offsets : data_.downward_offsets;
+            const ArrayView<uint32_t> graph_edges = forward_step ? data_.upward_edges : data_.downward_edges;
+            const ArrayView<uint32_t> next_vertices = forward_step ? data_.edge_to : data_.edge_from;
+            const QueueItem item = side.queue.top();
+            side.queue.pop();
+
+            if (const auto other_weight = other_side.workspace.FindWeight(item.vertex)) {
+                if (!best_weight || item.weight + *other_weight < *best_weight) {
+                    best_weight = item.weight + *other_weight;
+                    meeting_vertex = item.vertex;
+                }
+            }
+            for (uint32_t i = offsets[item.vertex]; i < offsets[item.vertex + 1]; ++i) {
+                const uint32_t edge_index = graph_edges[i];
+                const VertexId vertex = next_vertices[edge_index];
+                const Weight candidate_weight = item.weight + data_.edge_weight[edge_index];
+                if (!side.workspace.IsReached(vertex) || candidate_weight < side.workspace.GetWeight(vertex)) {
+                    side.workspace.Reach(vertex, candidate_weight, edge_index);
+                    side.queue.push({ candidate_weight, vertex });
+                }
+            }
+        }
+
+        if (!best_weight) {
+            return std::nullopt;
+        }
+        std::vector<uint32_t> forward_edges;
+        for (VertexId vertex = meeting_vertex; vertex != from; vertex = data_.edge_from[forward.workspace.GetPrevEdge(vertex)]) {
+            forward_edges.push_back(forward.workspace.GetPrevEdge(vertex));
+        }
+        std::vector<EdgeId> edges;
+        for (auto it = forward_edges.rbegin(); it != forward_edges.rend(); ++it) {
+            UnpackEdge(*it, edges);
+        }
+        for (VertexId vertex = meeting_vertex; vertex != to; vertex = data_.edge_to[backward.workspace.GetPrevEdge(vertex)]) {
+            UnpackEdge(backward.workspace.GetPrevEdge(vertex), edges);
+        }
+
+        return RouteInfo{ *best_weight, std::move(edges) };
+    }
+
+}  // namespace graph
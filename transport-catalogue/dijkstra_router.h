@@ -0,0 +1,192 @@
+#pragma once
+
+#include "router.h"
+#include "search_workspace.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+    template <typename Weight>
+    class DijkstraRouter : public RouteBuilder<Weight> {
+    private:
+        using Graph = DirectedWeightedGraph<Weight>;
+
+    public:
+        using typename RouteBuilder<Weight>::RouteInfo;
+        using Heuristic = std::function<Weight(VertexId vertex, VertexId target)>;
+
+        explicit DijkstraRouter(const Graph& graph, Heuristic heuristic = nullptr);
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+        std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const override;
+        std::vector<std::pair<VertexId, Weight>> BuildReachable(VertexId from, Weight max_weight) const;
+
+    private:
+        struct QueueItem {
+            Weight priority;
+            Weight weight;
+            VertexId vertex;
+
+            bool operator>(const QueueItem& other) const {
+                return priority > other.priority;
+            }
+        };
+        using Queue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+        static constexpr Weight ZERO_WEIGHT{};
+        static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+        const Graph& graph_;
+        Heuristic heuristic_;
+
+        Weight GetPriority(Weight weight, VertexId vertex, VertexId target) const {
+            return heuristic_ ? weight + heuristic_(vertex, target) : weight;
+        }
+    };
+
+    template <typename Weight>
+    DijkstraRouter<Weight>::DijkstraRouter(const Graph& graph, Heuristic heuristic)
+        : graph_(graph)
+        , heuristic_(std::move(heuristic))
+    {
+        for (EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+            if (graph.GetEdge(edge_id).weight < ZERO_WEIGHT) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+    }
+
+    template <typename Weight>
+    std::optional<typename DijkstraRouter<Weight>::RouteInfo> DijkstraRouter<Weight>::BuildRoute(VertexId from,
+        VertexId to) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+        SearchWorkspace<Weight>& workspace = GetThreadWorkspace<Weight>(0, vertex_count);
+        Queue queue;
+
+        workspace.Reach(from, ZERO_WEIGHT, NO_EDGE);
+        queue.push({ GetPriority(ZERO_WEIGHT, from, to), ZERO_WEIGHT, from });
+
+        while (!queue.empty()) {
+            const QueueItem item = queue.top();
+            queue.pop();
+            if (item.weight > workspace.GetWeight(item.vertex)) {
+                continue;
+            }
+            if (item.vertex == to) {
+                break;
+            }
+            graph_.ForEachIncidentEdge(item.vertex, [&](EdgeId edge_id, VertexId vertex_to, Weight edge_weight) {
+                const Weight candidate_weight = item.weight + edge_weight;
+                if (!workspace.IsReached(vertex_to) || candidate_weight < workspace.GetWeight(vertex_to)) {
+                    workspace.Reach(vertex_to, candidate_weight, edge_id);
+                    queue.push({ GetPriority(candidate_weight, vertex_to, to), candidate_weight, vertex_to });
+                }
+                });
+        }
+
+        if (!workspace.IsReached(to)) {
+            return std::nullopt;
+        }
+        std::vector<EdgeId> edges;
+        for (VertexId vertex = to; vertex != from; vertex = graph_.GetEdge(workspace.GetPrevEdge(vertex)).from) {
+            edges.push_back(workspace.GetPrevEdge(vertex));
+        }
+        std::reverse(edges.begin(), edges.end());
+
+        return RouteInfo{ workspace.GetWeight(to), std::move(edges) };
+    }
+
+    //      ;    
+    template <typename Weight>
+    std::vector<std::optional<Weight>> DijkstraRouter<Weight>::BuildWeights(VertexId from,
+        const std::vector<VertexId>& targets) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+        std::vector<bool> is_target(vertex_count, false);
+        size_t targets_left = 0;
+        for (const VertexId to : targets) {
+            if (!is_target.at(to)) {
+                is_target[to] = true;
+                ++targets_left;
+            }
+        }
+        SearchWorkspace<Weight>& workspace = GetThreadWorkspace<Weight>(0, vertex_count);
+        Queue queue;
+
+        workspace.Reach(from, ZERO_WEIGHT, NO_EDGE);
+        queue.push({ ZERO_WEIGHT, ZERO_WEIGHT, from });
+
+        while (!queue.empty() && targets_left > 0) {
+            const QueueItem item = queue.top();
+            queue.pop();
+            if (item.weight > workspace.GetWeight(item.vertex)) {
+                continue;
+            }
+            if (is_target[item.vertex]) {
+                is_target[item.vertex] = false;
+                --targets_left;
+            }
+            graph_.ForEachIncidentEdge(item.vertex, [&](EdgeId edge_id, VertexId vertex_to, Weight edge_weight) {
+                const Weight candidate_weight = item.weight + edge_weight;
+                if (!workspace.IsReached(vertex_to) || candidate_weight < workspace.GetWeight(vertex_to)) {
+                    workspace.Reach(vertex_to, candidate_weight, edge_id);
+                    queue.push({ candidate_weight, candidate_weight, vertex_to });
+                }
+                });
+        }
+
+        std::vector<std::optional<Weight>> result;
+        result.reserve(targets.size());
+        for (const VertexId to : targets) {
+            result.push_back(workspace.FindWeight(to));
+        }
+        return result;
+    }
+
+    //     ;     max_weight
+    template <typename Weight>
+    std::vector<std::pair<VertexId, Weight>> DijkstraRouter<Weight>::BuildReachable(VertexId from,
+        Weight max_weight) const {
+        const size_t vertex_count = graph_.GetVertexCount();
+        if (from >= vertex_count) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+        SearchWorkspace<Weight>& workspace = GetThreadWorkspace<Weight>(0, vertex_count);
+        std::vector<std::pair<VertexId, Weight>> reachable;
+        Queue queue;
+
+        workspace.Reach(from, ZERO_WEIGHT, NO_EDGE);
+        queue.push({ ZERO_WEIGHT, ZERO_WEIGHT, from });
+
+        while (!queue.empty()) {
+            const QueueItem item = queue.top();
+            queue.pop();
+            if (item.weight > workspace.GetWeight(item.vertex)) {
+                continue;
+            }
+            reachable.emplace_back(item.vertex, item.weight);
+            graph_.ForEachIncidentEdge(item.vertex, [&](EdgeId edge_id, VertexId vertex_to, Weight edge_weight) {
+                const Weight candidate_weight = item.weight + edge_weight;
+                if (candidate_weight <= max_weight
+                    && (!workspace.IsReached(vertex_to) || candidate_weight < workspace.GetWeight(vertex_to))) {
+                    workspace.Reach(vertex_to, candidate_weight, edge_id);
+                    queue.push({ candidate_weight, candidate_weight, vertex_to });
+                }
+                });
+        }
+        return reachable;
+    }
+
+}  // namespace graph
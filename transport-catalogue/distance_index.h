@@ -0,0 +1,153 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "array_view.h"
+
+//      (from, to)      .
+//       ,  -     .
+//      ,    
+class DistanceIndex {
+public:
+    static constexpr uint64_t EMPTY_KEY = std::numeric_limits<uint64_t>::max();
+
+    DistanceIndex() = default;
+    //     ,      
+    DistanceIndex(const DistanceIndex&) = delete;
+    DistanceIndex& operator=(const DistanceIndex&) = delete;
+
+    //         -  insert  unordered_map
+    void Insert(uint32_t from, uint32_t to, int meters) {
+        if (attached_) {
+            throw std::logic_error("DistanceIndex::Insert() on attached slots");
+        }
+        if ((size_ + 1) * 2 > keys_.size()) {
+            Rehash(std::max<size_t>(keys_.size() * 2, MIN_CAPACITY));
+        }
+        const uint64_t key = PackKey(from, to);
+        size_t slot = FindSlot(key);
+        if (keys_[slot] == EMPTY_KEY) {
+            owned_keys_[slot] = key;
+            owned_meters_[slot] = meters;
+            ++size_;
+        }
+    }
+
+    //    ;     .   -  ,
+    //    ,       
+    void Attach(ArrayView<uint64_t> keys, ArrayView<int32_t> meters, size_t size) {
+        if (size_ != 0 || attached_) {
+            throw std::logic_error("DistanceIndex::Attach() expects an empty index");
+        }
+        keys_ = keys;
+        meters_ = meters;
+        size_ = size;
+        attached_ = true;
+    }
+
+    ArrayView<uint64_t> GetSlotKeys() const {
+        return keys_;
+    }
+
+    ArrayView<int32_t> GetSlotMeters() const {
+        return meters_;
+    }
+
+    static uint32_t GetKeyFrom(uint64_t key) {
+        return static_cast<uint32_t>(key >> 32);
+    }
+
+    static uint32_t GetKeyTo(uint64_t key) {
+        return static_cast<uint32_t>(key);
+    }
+
+    std::optional<int> Find(uint32_t from, uint32_t to) const {
+        if (keys_.empty()) {
+            return std::nullopt;
+        }
+        const uint64_t key = PackKey(from, to);
+        const size_t slot = FindSlot(key);
+        return keys_[slot] == key ? std::optional<int>(meters_[slot]) : std::nullopt;
+    }
+
+    size_t GetSize() const {
+        return size_;
+    }
+
+    void Reserve(size_t count) {
+        if (attached_) {
+            return;
+        }
+        size_t capacity = std::max<size_t>(keys_.size(), MIN_CAPACITY);
+        while (capacity < count * 2) {
+            capacity *= 2;
+        }
+        if (capacity > keys_.size()) {
+            Rehash(capacity);
+        }
+    }
+
+    //    : func(from, to, meters)
+    template <typename Func>
+    void ForEach(Func func) const {
+        for (size_t slot = 0; slot < keys_.size(); ++slot) {
+            if (keys_[slot] != EMPTY_KEY) {
+                func(GetKeyFrom(keys_[slot]), GetKeyTo(keys_[slot]), meters_[slot]);
+            }
+        }
+    }
+
+private:
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    static uint64_t PackKey(uint32_t from, uint32_t to) {
+        return (static_cast<uint64_t>(from) << 32) | to;
+    }
+
+    //  splitmix64: (a, b), (b, a)  (a, a)    
+    static uint64_t Mix(uint64_t key) {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return key;
+    }
+
+    size_t FindSlot(uint64_t key) const {
+        const size_t mask = keys_.size() - 1;
+        size_t slot = static_cast<size_t>(Mix(key)) & mask;
+        while (keys_[slot] != key && keys_[slot] != EMPTY_KEY) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void Rehash(size_t capacity) {
+        std::vector<uint64_t> old_keys = std::exchange(owned_keys_, std::vector<uint64_t>(capacity, EMPTY_KEY));
+        std::vector<int32_t> old_meters = std::exchange(owned_meters_, std::vector<int32_t>(capacity));
+        keys_ = owned_keys_;
+        meters_ = owned_meters_;
+        for (size_t i = 0; i < old_keys.size(); ++i) {
+            if (old_keys[i] != EMPTY_KEY) {
+                const size_t slot = FindSlot(old_keys[i]);
+                owned_keys_[slot] = old_keys[i];
+                owned_meters_[slot] = old_meters[i];
+            }
+        }
+    }
+
+    std::vector<uint64_t> owned_keys_;
+    std::vector<int32_t> owned_meters_;
+    //    :    owned_*    
+    ArrayView<uint64_t> keys_;
+    ArrayView<int32_t> meters_;
+    size_t size_ = 0;
+    bool attached_ = false;
+};
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "array_view.h"
 #include "geo.h"
 
 enum class EdgeType {
@@ -11,18 +14,36 @@ enum class EdgeType {
     WAIT,
 };
 
+enum class RouterType {
+    ALL_PAIRS,
+    DIJKSTRA,
+    A_STAR,
+    BIDIRECTIONAL,
+    CONTRACTION_HIERARCHY,
+    RAPTOR,
+};
+
+//       
+using StopId = uint32_t;
+using BusId = uint32_t;
+
+// ,    -  ,   
+//   ,    
 struct Stop {
-    std::string stop_name;
+    std::string_view stop_name;
     geo::Coordinates coordinates;
+    StopId id = 0;
 };
 
-using TypeRoute = std::pair<bool, const Stop*>;
+using TypeRoute = std::pair<bool, StopId>;
 
 struct Bus {
-    Bus(std::string& bus_name);
-    std::string bus_name;
-    std::vector<Stop*> stops;
+    Bus(std::string_view bus_name);
+    std::string_view bus_name;
+    ArrayView<StopId> stops;
     TypeRoute is_roundtrip;
+    BusId id = 0;
+    ArrayView<double> departures;  //     , 
 };
 
 struct BusStat {
@@ -44,8 +65,7 @@ struct RoutingSettings {
 
     double bus_wait_time = 0.0;
     double bus_velocity  = 0.0;
-};
-
-struct StopPairHasher {
-    std::size_t operator()(const std::pair<const Stop*, const Stop*>& pair) const;
+    RouterType router_type = RouterType::ALL_PAIRS;
+    size_t router_thread_count = 0;
+    bool router_compact_table = false;
 };
\ No newline at end of file
@@ -2,10 +2,142 @@
 
 #include "geo.h"
 
+#include <array>
 #include <cmath>
 
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#define GEO_AVX2_KERNEL
+#define GEO_TARGET_AVX2
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define GEO_AVX2_KERNEL
+#define GEO_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
 namespace geo {
 
+    namespace {
+
+        constexpr double EARTH_RADIUS = 6371000;
+        constexpr double DEG_TO_RAD = M_PI / 180.0;
+
+        //     ,       ~1600 
+        //      0.25 ;    
+        constexpr double MAX_SERIES_LNG_DELTA = 0.25;
+        constexpr double MAX_SERIES_ONE_MINUS_COS = 0.03125;
+
+        // cos(t) = sum (-1)^k t^2k / (2k)!
+        constexpr std::array<double, 9> COS_SERIES = {
+            1.0, -1.0 / 2, 1.0 / 24, -1.0 / 720, 1.0 / 40320, -1.0 / 3628800,
+            1.0 / 479001600, -1.0 / 87178291200, 1.0 / 20922789888000 };
+        // asin(h) = h * sum (2k)! / (4^k (k!)^2 (2k + 1)) h^2k
+        constexpr std::array<double, 9> ASIN_SERIES = {
+            1.0, 1.0 / 6, 3.0 / 40, 5.0 / 112, 35.0 / 1152, 63.0 / 2816,
+            231.0 / 13312, 143.0 / 10240, 6435.0 / 557056 };
+
+        using DistancesKernel = void (*)(const CoordinateArrays&, const uint32_t*, const uint32_t*, size_t, double*);
+
+        void ComputeDistancesScalar(const CoordinateArrays& coordinates, const uint32_t* from, const uint32_t* to,
+            size_t count, double* distances) {
+            for (size_t i = 0; i < count; ++i) {
+                distances[i] = coordinates.ComputeDistance(from[i], to[i]);
+            }
+        }
+
+#ifdef GEO_AVX2_KERNEL
+        GEO_TARGET_AVX2 __m256d EvaluateSeries(const std::array<double, 9>& series, __m256d x) {
+            __m256d result = _mm256_set1_pd(series.back());
+            for (size_t k = series.size() - 1; k-- > 0;) {
+                result = _mm256_add_pd(_mm256_mul_pd(result, x), _mm256_set1_pd(series[k]));
+            }
+            return result;
+        }
+
+        //     :  _mm256_i32gather_pd   ,
+        //  GCC    
+        GEO_TARGET_AVX2 __m256d Gather(const double* base, __m128i index) {
+            const __m256d all_lanes = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+            return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, index, all_lanes, 8);
+        }
+
+        // acos(x) = 2 * asin(sqrt((1 - x) / 2));  x   1   asin  
+        GEO_TARGET_AVX2 void ComputeDistancesAvx2(const CoordinateArrays& coordinates, const uint32_t* from,
+            const uint32_t* to, size_t count, double* distances) {
+            const double* sin_lat = coordinates.GetSinLatitudes().data();
+            const double* cos_lat = coordinates.GetCosLatitudes().data();
+            const double* lng = coordinates.GetLongitudes().data();
+            const __m256d sign_mask = _mm256_set1_pd(-0.0);
+            const __m256d one = _mm256_set1_pd(1.0);
+            const __m256d half = _mm256_set1_pd(0.5);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const __m128i index_from = _mm_loadu_si128(reinterpret_cast<const __m128i*>(from + i));
+                const __m128i index_to = _mm_loadu_si128(reinterpret_cast<const __m128i*>(to + i));
+                const __m256d sin_from = Gather(sin_lat, index_from);
+                const __m256d sin_to = Gather(sin_lat, index_to);
+                const __m256d cos_from = Gather(cos_lat, index_from);
+                const __m256d cos_to = Gather(cos_lat, index_to);
+                const __m256d lng_delta = _mm256_mul_pd(
+                    _mm256_andnot_pd(sign_mask, _mm256_sub_pd(Gather(lng, index_from), Gather(lng, index_to))),
+                    _mm256_set1_pd(DEG_TO_RAD));
+
+                const __m256d cos_lng_delta = EvaluateSeries(COS_SERIES, _mm256_mul_pd(lng_delta, lng_delta));
+                const __m256d cos_angle = _mm256_add_pd(_mm256_mul_pd(sin_from, sin_to),
+                    _mm256_mul_pd(_mm256_mul_pd(cos_from, cos_to), cos_lng_delta));
+                const __m256d one_minus_cos = _mm256_max_pd(_mm256_sub_pd(one, cos_angle), _mm256_setzero_pd());
+                const __m256d half_chord_sq = _mm256_mul_pd(one_minus_cos, half);
+                const __m256d half_chord = _mm256_sqrt_pd(half_chord_sq);
+                const __m256d angle = _mm256_mul_pd(_mm256_set1_pd(2.0),
+                    _mm256_mul_pd(half_chord, EvaluateSeries(ASIN_SERIES, half_chord_sq)));
+                _mm256_storeu_pd(distances + i, _mm256_mul_pd(angle, _mm256_set1_pd(EARTH_RADIUS)));
+
+                const __m256d in_range = _mm256_and_pd(
+                    _mm256_cmp_pd(lng_delta, _mm256_set1_pd(MAX_SERIES_LNG_DELTA), _CMP_LE_OQ),
+                    _mm256_cmp_pd(one_minus_cos, _mm256_set1_pd(MAX_SERIES_ONE_MINUS_COS), _CMP_LE_OQ));
+                const int in_range_mask = _mm256_movemask_pd(in_range);
+                if (in_range_mask != 0b1111) {
+                    for (size_t lane = 0; lane < 4; ++lane) {
+                        if ((in_range_mask & (1 << lane)) == 0) {
+                            distances[i + lane] = coordinates.ComputeDistance(from[i + lane], to[i + lane]);
+                        }
+                    }
+                }
+            }
+            ComputeDistancesScalar(coordinates, from + i, to + i, count - i, distances + i);
+        }
+
+        bool CpuSupportsAvx2() {
+#if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 1);
+            const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+            const bool has_avx = (info[2] & (1 << 28)) != 0;
+            __cpuidex(info, 7, 0);
+            return os_saves_ymm && has_avx && (info[1] & (1 << 5)) != 0;
+#else
+            return __builtin_cpu_supports("avx2");
+#endif
+        }
+#endif
+
+        DistancesKernel SelectDistancesKernel() {
+#ifdef GEO_AVX2_KERNEL
+            if (CpuSupportsAvx2()) {
+                return ComputeDistancesAvx2;
+            }
+#endif
+            return ComputeDistancesScalar;
+        }
+
+        DistancesKernel GetDistancesKernel() {
+            static const DistancesKernel kernel = SelectDistancesKernel();
+            return kernel;
+        }
+
+    }  // namespace
+
     double ComputeDistance(Coordinates from, Coordinates to) {
         using namespace std;
         const double dr = M_PI / 180.0;
@@ -14,4 +146,35 @@ namespace geo {
             * 6371000;
     }
 
+    void CoordinateArrays::Reserve(size_t count) {
+        lat_.reserve(count);
+        lng_.reserve(count);
+        lat_rad_.reserve(count);
+        lng_rad_.reserve(count);
+        sin_lat_.reserve(count);
+        cos_lat_.reserve(count);
+    }
+
+    void CoordinateArrays::Add(Coordinates coordinates) {
+        const double dr = M_PI / 180.0;
+        lat_.push_back(coordinates.lat);
+        lng_.push_back(coordinates.lng);
+        lat_rad_.push_back(coordinates.lat * dr);
+        lng_rad_.push_back(coordinates.lng * dr);
+        sin_lat_.push_back(std::sin(coordinates.lat * dr));
+        cos_lat_.push_back(std::cos(coordinates.lat * dr));
+    }
+
+    double CoordinateArrays::ComputeDistance(size_t from, size_t to) const {
+        using namespace std;
+        const double dr = M_PI / 180.0;
+        return acos(sin_lat_[from] * sin_lat_[to]
+            + cos_lat_[from] * cos_lat_[to] * cos(abs(lng_[from] - lng_[to]) * dr))
+            * 6371000;
+    }
+
+    void CoordinateArrays::ComputeDistances(const uint32_t* from, const uint32_t* to, size_t count, double* distances) const {
+        GetDistancesKernel()(*this, from, to, count, distances);
+    }
+
 }  // namespace geo
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "array_view.h"
 
 namespace geo {
 
@@ -11,17 +15,47 @@ namespace geo {
 
     double ComputeDistance(Coordinates from, Coordinates to);
 
-    template <typename Bus>
-    inline double ComputeCurvature(const Bus* bus, double length_fact) {
+    //       ,  
+    //   /  -      
+    class CoordinateArrays {
+    public:
+        void Add(Coordinates coordinates);
+        void Reserve(size_t count);
+
+        size_t GetSize() const { return lat_.size(); }
+        Coordinates Get(size_t index) const { return { lat_[index], lng_[index] }; }
+
+        const std::vector<double>& GetLatitudes()      const { return lat_; }
+        const std::vector<double>& GetLongitudes()     const { return lng_; }
+        const std::vector<double>& GetLatitudesRad()   const { return lat_rad_; }
+        const std::vector<double>& GetLongitudesRad()  const { return lng_rad_; }
+        const std::vector<double>& GetSinLatitudes()   const { return sin_lat_; }
+        const std::vector<double>& GetCosLatitudes()   const { return cos_lat_; }
+
+        //   ComputeDistance(Get(from), Get(to)),     
+        double ComputeDistance(size_t from, size_t to) const;
+
+        // distances[i] = ComputeDistance(from[i], to[i]).     AVX2
+        //   ;     -   1e-9   1e-6  
+        void ComputeDistances(const uint32_t* from, const uint32_t* to, size_t count, double* distances) const;
+
+    private:
+        std::vector<double> lat_;
+        std::vector<double> lng_;
+        std::vector<double> lat_rad_;
+        std::vector<double> lng_rad_;
+        std::vector<double> sin_lat_;
+        std::vector<double> cos_lat_;
+    };
+
+    //  ,       
+    inline double ComputeCurvature(const CoordinateArrays& coordinates, ArrayView<uint32_t> route, double length_fact) {
         double length(0.0);
-        for (size_t i = 0; i < bus->stops.size() - 1; ++i) {
-            auto from = bus->stops[i];
-            auto to = bus->stops[i + 1];
-            length += ComputeDistance(from->coordinates, to->coordinates);
+        for (size_t i = 0; i + 1 < route.size(); ++i) {
+            length += coordinates.ComputeDistance(route[i], route[i + 1]);
         }
         return (length_fact / length);
     }
-
 }  // namespace geo
 
 
@@ -1,13 +1,16 @@
 #pragma once
 
 #include "ranges.h"
+#include <cstdint>
 #include <cstdlib>
+#include <limits>
+#include <stdexcept>
 #include <vector>
 
 namespace graph {
 
-    using VertexId = size_t;
-    using EdgeId = size_t;
+    using VertexId = uint32_t;
+    using EdgeId = uint32_t;
 
     template <typename Weight>
     struct Edge {
@@ -16,11 +19,13 @@ namespace graph {
         Weight weight;
     };
 
+    //  Freeze()     EdgeId   . Freeze()  
+    //   CSR    ,     
     template <typename Weight>
     class DirectedWeightedGraph {
     private:
         using IncidenceList = std::vector<EdgeId>;
-        using IncidentEdgesRange = ranges::Range<typename IncidenceList::const_iterator>;
+        using IncidentEdgesRange = ranges::Range<const EdgeId*>;
 
     public:
         DirectedWeightedGraph() = default;
@@ -29,45 +34,182 @@ namespace graph {
 
         size_t GetVertexCount() const;
         size_t GetEdgeCount() const;
-        const Edge<Weight>& GetEdge(EdgeId edge_id) const;
+        Edge<Weight> GetEdge(EdgeId edge_id) const;
         IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
 
+        void Freeze();
+        bool IsFrozen() const;
+        void BuildIncomingIndex();
+        bool HasIncomingIndex() const;
+
+        template <typename Callback>
+        void ForEachIncidentEdge(VertexId vertex, Callback callback) const;
+        template <typename Callback>
+        void ForEachIncomingEdge(VertexId vertex, Callback callback) const;
+
     private:
+        size_t vertex_count_ = 0;
+        bool frozen_ = false;
         std::vector<Edge<Weight>> edges_;
         std::vector<IncidenceList> incidence_lists_;
+
+        //  CSR   ; edge_slots_ -     EdgeId
+        std::vector<EdgeId> offsets_;
+        std::vector<EdgeId> adjacent_edges_;
+        std::vector<VertexId> adjacent_sources_;
+        std::vector<VertexId> adjacent_vertices_;
+        std::vector<Weight> adjacent_weights_;
+        std::vector<EdgeId> edge_slots_;
+
+        //   ,    
+        std::vector<EdgeId> incoming_offsets_;
+        std::vector<EdgeId> incoming_slots_;
     };
 
     template <typename Weight>
     DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
-        : incidence_lists_(vertex_count) {
+        : vertex_count_(vertex_count)
+        , incidence_lists_(vertex_count) {
+        if (vertex_count > std::numeric_limits<VertexId>::max()) {
+            throw std::length_error("Too many vertices");
+        }
     }
 
     template <typename Weight>
     EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight>& edge) {
+        if (frozen_) {
+            throw std::logic_error("Can't add an edge to a frozen graph");
+        }
+        if (edges_.size() >= std::numeric_limits<EdgeId>::max()) {
+            throw std::length_error("Too many edges");
+        }
+        if (edge.to >= vertex_count_) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+        incidence_lists_.at(edge.from).push_back(static_cast<EdgeId>(edges_.size()));
         edges_.push_back(edge);
-        const EdgeId id = edges_.size() - 1;
-        incidence_lists_.at(edge.from).push_back(id);
-        return id;
+        return static_cast<EdgeId>(edges_.size() - 1);
     }
 
     template <typename Weight>
     size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
-        return incidence_lists_.size();
+        return vertex_count_;
     }
 
     template <typename Weight>
     size_t DirectedWeightedGraph<Weight>::GetEdgeCount() const {
-        return edges_.size();
+        return frozen_ ? adjacent_edges_.size() : edges_.size();
     }
 
     template <typename Weight>
-    const Edge<Weight>& DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const {
+    Edge<Weight> DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const {
+        if (frozen_) {
+            const EdgeId slot = edge_slots_.at(edge_id);
+            return { adjacent_sources_[slot], adjacent_vertices_[slot], adjacent_weights_[slot] };
+        }
         return edges_.at(edge_id);
     }
 
     template <typename Weight>
     typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
         DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
-        return ranges::AsRange(incidence_lists_.at(vertex));
+        if (frozen_) {
+            const EdgeId* adjacent_edges = adjacent_edges_.data();
+            return { adjacent_edges + offsets_.at(vertex), adjacent_edges + offsets_[vertex + 1] };
+        }
+        const IncidenceList& incidence_list = incidence_lists_.at(vertex);
+        return { incidence_list.data(), incidence_list.data() + incidence_list.size() };
+    }
+
+    template <typename Weight>
+    void DirectedWeightedGraph<Weight>::Freeze() {
+        if (frozen_) {
+            return;
+        }
+        offsets_.assign(vertex_count_ + 1, 0);
+        for (size_t vertex = 0; vertex < vertex_count_; ++vertex) {
+            offsets_[vertex + 1] = offsets_[vertex] + static_cast<EdgeId>(incidence_lists_[vertex].size());
+        }
+
+        const size_t edge_count = edges_.size();
+        adjacent_edges_.reserve(edge_count);
+        adjacent_sources_.reserve(edge_count);
+        adjacent_vertices_.reserve(edge_count);
+        adjacent_weights_.reserve(edge_count);
+        edge_slots_.resize(edge_count);
+        for (const IncidenceList& incidence_list : incidence_lists_) {
+            for (const EdgeId edge_id : incidence_list) {
+                const Edge<Weight>& edge = edges_[edge_id];
+                edge_slots_[edge_id] = static_cast<EdgeId>(adjacent_edges_.size());
+                adjacent_edges_.push_back(edge_id);
+                adjacent_sources_.push_back(edge.from);
+                adjacent_vertices_.push_back(edge.to);
+                adjacent_weights_.push_back(edge.weight);
+            }
+        }
+
+        std::vector<IncidenceList>().swap(incidence_lists_);
+        std::vector<Edge<Weight>>().swap(edges_);
+        frozen_ = true;
+    }
+
+    template <typename Weight>
+    bool DirectedWeightedGraph<Weight>::IsFrozen() const {
+        return frozen_;
+    }
+
+    template <typename Weight>
+    void DirectedWeightedGraph<Weight>::BuildIncomingIndex() {
+        if (!frozen_) {
+            throw std::logic_error("Incoming index can be built only for a frozen graph");
+        }
+        if (HasIncomingIndex()) {
+            return;
+        }
+        incoming_offsets_.assign(vertex_count_ + 1, 0);
+        for (const VertexId vertex_to : adjacent_vertices_) {
+            ++incoming_offsets_[vertex_to + 1];
+        }
+        for (size_t vertex = 0; vertex < vertex_count_; ++vertex) {
+            incoming_offsets_[vertex + 1] += incoming_offsets_[vertex];
+        }
+
+        incoming_slots_.resize(adjacent_edges_.size());
+        std::vector<EdgeId> positions(incoming_offsets_.begin(), incoming_offsets_.end() - 1);
+        for (EdgeId slot = 0; slot < adjacent_edges_.size(); ++slot) {
+            incoming_slots_[positions[adjacent_vertices_[slot]]++] = slot;
+        }
+    }
+
+    template <typename Weight>
+    bool DirectedWeightedGraph<Weight>::HasIncomingIndex() const {
+        return !incoming_offsets_.empty();
+    }
+
+    template <typename Weight>
+    template <typename Callback>
+    void DirectedWeightedGraph<Weight>::ForEachIncidentEdge(VertexId vertex, Callback callback) const {
+        if (frozen_) {
+            for (EdgeId slot = offsets_[vertex]; slot < offsets_[vertex + 1]; ++slot) {
+                callback(adjacent_edges_[slot], adjacent_vertices_[slot], adjacent_weights_[slot]);
+            }
+            return;
+        }
+        for (const EdgeId edge_id : incidence_lists_[vertex]) {
+            const Edge<Weight>& edge = edges_[edge_id];
+            callback(edge_id, edge.to, edge.weight);
+        }
+    }
+
+    template <typename Weight>
+    template <typename Callback>
+    void DirectedWeightedGraph<Weight>::ForEachIncomingEdge(VertexId vertex, Callback callback) const {
+        if (!HasIncomingIndex()) {
+            throw std::logic_error("Graph has no incoming index");
+        }
+        for (EdgeId i = incoming_offsets_[vertex]; i < incoming_offsets_[vertex + 1]; ++i) {
+            const EdgeId slot = incoming_slots_[i];
+            callback(adjacent_edges_[slot], adjacent_sources_[slot], adjacent_weights_[slot]);
+        }
     }
 }  // namespace graph
\ No newline at end of file
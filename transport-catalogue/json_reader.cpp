@@ -1,12 +1,208 @@
 #include "json_reader.h"
 
-inline std::set<std::string> SortBuses(const std::unordered_set<Bus*>* buses) {
-    std::set<std::string> sorted;
-    for (Bus* bus : *buses) sorted.emplace(bus->bus_name);
-    return sorted;
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+//     -    :       
+constexpr size_t MAX_BUS_DEPARTURES = 100000;
+
+inline RouterType ParseRouterType(const std::string& type) {
+    if (type == "all_pairs")              return RouterType::ALL_PAIRS;
+    if (type == "dijkstra")               return RouterType::DIJKSTRA;
+    if (type == "a_star")                 return RouterType::A_STAR;
+    if (type == "bidirectional")          return RouterType::BIDIRECTIONAL;
+    if (type == "contraction_hierarchy")  return RouterType::CONTRACTION_HIERARCHY;
+    if (type == "raptor")                 return RouterType::RAPTOR;
+    throw std::invalid_argument("Unknown router type: " + type);
+}
+
+//   "departures"    first_departure..last_departure
+inline std::vector<double> ParseDepartures(const json::Dict& bus) {
+    std::vector<double> departures;
+    if (bus.count("departures")) {
+        for (const json::Node& departure : bus.at("departures").AsArray()) {
+            departures.push_back(departure.AsDouble());
+        }
+    }
+    else if (bus.count("interval")) {
+        const double interval = bus.at("interval").AsDouble();
+        if (interval <= 0.0) {
+            throw std::invalid_argument("Bus interval should be positive");
+        }
+        const double first_departure = bus.at("first_departure").AsDouble();
+        const double last_departure = bus.at("last_departure").AsDouble();
+        if (last_departure < first_departure) {
+            return departures;
+        }
+        //      first + k * interval,     .
+        //      ,       
+        const double steps = std::floor((last_departure - first_departure) / interval + 1e-9);
+        if (!(steps < MAX_BUS_DEPARTURES)) {
+            throw std::invalid_argument("Too many bus departures");
+        }
+        const size_t count = static_cast<size_t>(steps) + 1;
+        departures.reserve(count);
+        for (size_t k = 0; k < count; ++k) {
+            departures.push_back(std::min(first_departure + k * interval, last_departure));
+        }
+    }
+    return departures;
 }
 
 namespace json {
+
+    namespace {
+
+        void AddBaseRequest(const Dict& request, NetworkDescription& network) {
+            if (request.at("type").AsString() == "Stop") {
+                network.stops.push_back({ request.at("name").AsString(),
+                    { request.at("latitude").AsDouble(), request.at("longitude").AsDouble() } });
+                for (const auto& [to_stop, distance] : request.at("road_distances").AsDict()) {
+                    network.distances.push_back({ request.at("name").AsString(), to_stop, distance.AsInt() });
+                }
+            }
+            else if (request.at("type").AsString() == "Bus") {
+                BusDescription bus;
+                bus.name = request.at("name").AsString();
+                for (const Node& stop : request.at("stops").AsArray()) {
+                    bus.stops.emplace_back(stop.AsString());
+                }
+                bus.is_roundtrip = request.at("is_roundtrip").AsBool();
+                bus.departures = ParseDepartures(request);
+                network.buses.push_back(std::move(bus));
+            }
+        }
+
+        //      ,  base_requests:   base_requests
+        //  ,       .
+        //            
+        class StreamingLoader final : public SaxHandler {
+        public:
+            explicit StreamingLoader(NetworkDescription& network)
+                : network_(network) {
+            }
+
+            void StartDict() override {
+                StartContainer(true);
+            }
+
+            void Key(std::string_view key) override {
+                if (depth_ == 1) {
+                    key_ = key;
+                }
+                else {
+                    builder_->Key(std::string(key));
+                }
+            }
+
+            void EndDict() override {
+                EndContainer(true);
+            }
+
+            void StartArray() override {
+                StartContainer(false);
+            }
+
+            void EndArray() override {
+                EndContainer(false);
+            }
+
+            void String(std::string_view value) override {
+                Value(std::string(value));
+            }
+
+            void Value(Node::Value value) override {
+                if (depth_ <= 1) {
+                    if (depth_ == 0) {
+                        throw ParsingError("Document root should be a dict");
+                    }
+                    root_[key_] = Node(std::move(value));
+                    return;
+                }
+                if (subtree_depth_ == 0) {
+                    builder_.emplace();
+                }
+                builder_->Value(std::move(value));
+                if (subtree_depth_ == 0) {
+                    CompleteSubtree();
+                }
+            }
+
+            Dict ExtractRoot() {
+                return std::move(root_);
+            }
+
+        private:
+            void StartContainer(bool is_dict) {
+                ++depth_;
+                if (depth_ == 1) {
+                    if (!is_dict) {
+                        throw ParsingError("Document root should be a dict");
+                    }
+                    return;
+                }
+                if (depth_ == 2 && key_ == "base_requests") {
+                    if (is_dict) {
+                        throw ParsingError("base_requests should be an array");
+                    }
+                    in_base_requests_ = true;
+                    return;
+                }
+                if (subtree_depth_++ == 0) {
+                    builder_.emplace();
+                }
+                if (is_dict) {
+                    builder_->StartDict();
+                }
+                else {
+                    builder_->StartArray();
+                }
+            }
+
+            void EndContainer(bool is_dict) {
+                --depth_;
+                if (depth_ == 0) {
+                    return;
+                }
+                if (depth_ == 1 && in_base_requests_) {
+                    in_base_requests_ = false;
+                    return;
+                }
+                --subtree_depth_;
+                if (is_dict) {
+                    builder_->EndDict();
+                }
+                else {
+                    builder_->EndArray();
+                }
+                if (subtree_depth_ == 0) {
+                    CompleteSubtree();
+                }
+            }
+
+            void CompleteSubtree() {
+                Node node = builder_->Build();
+                builder_.reset();
+                if (in_base_requests_) {
+                    AddBaseRequest(node.AsDict(), network_);
+                }
+                else {
+                    root_[key_] = std::move(node);
+                }
+            }
+
+            NetworkDescription& network_;
+            Dict root_;
+            std::string key_;
+            std::optional<Builder> builder_;
+            size_t depth_ = 0;
+            size_t subtree_depth_ = 0;
+            bool in_base_requests_ = false;
+        };
+
+    }  // namespace
+
     void JsonReader::LoadHandler(RequestHandler handler) {
         handler_ = std::move(std::make_unique<RequestHandler>(handler));
     }
@@ -15,6 +211,33 @@ namespace json {
         document_ = std::move(std::make_unique<Document>(Load(input)));
     }
 
+    void JsonReader::LoadJson(std::string_view input) {
+        document_ = std::make_unique<Document>(Load(input));
+    }
+
+    NetworkDescription JsonReader::LoadJsonStreaming(std::istream& input) {
+        NetworkDescription network;
+        StreamingLoader loader(network);
+        Parse(input, loader);
+        SetStreamedDocument(loader.ExtractRoot(), network);
+        return network;
+    }
+
+    NetworkDescription JsonReader::LoadJsonStreaming(std::string_view input) {
+        NetworkDescription network;
+        StreamingLoader loader(network);
+        Parse(input, loader);
+        SetStreamedDocument(loader.ExtractRoot(), network);
+        return network;
+    }
+
+    void JsonReader::SetStreamedDocument(Dict root, NetworkDescription& network) {
+        document_ = std::make_unique<Document>(Node(std::move(root)));
+        if (document_->GetRoot().AsDict().count("routing_settings")) {
+            network.routing_settings = ParseRoutingSettings();
+        }
+    }
+
     const std::vector<Node>& JsonReader::GetBaseRequests() const {
         return document_->GetRoot().AsDict().at("base_requests").AsArray();
     }
@@ -31,59 +254,31 @@ namespace json {
         return document_->GetRoot().AsDict().at("routing_settings").AsDict();
     }
 
-    void JsonReader::AddStopsDataToCatalogue() const {
-        for (const Node& node : GetBaseRequests()) {
-            if (node.AsDict().at("type").AsString() == "Stop") {
-
-                std::string name = node.AsDict().at("name").AsString();
-                double latitude = node.AsDict().at("latitude").AsDouble();
-                double longitude = node.AsDict().at("longitude").AsDouble();
-
-                const_cast<TransportCatalogue&>(handler_->GetDataBase())
-                    .AddStop(name, { latitude , longitude });
-
-            }
-        }
+    NetworkDescription JsonReader::ParseNetwork() const {
+        NetworkDescription network;
         for (const Node& node : GetBaseRequests()) {
-            if (node.AsDict().at("type").AsString() == "Stop") {
-                if (!node.AsDict().at("road_distances").AsDict().empty()) {
-                    std::string name = node.AsDict().at("name").AsString();
-                    for (const std::pair<const std::string, const Node>& stop : node.AsDict().at("road_distances").AsDict()) {
-                        std::string to_stop = stop.first;
-                        Distance dist(node.AsDict().at("road_distances").AsDict().at(to_stop).AsInt());
-                        const_cast<TransportCatalogue&>(handler_->GetDataBase())
-                            .SetDistanceBetweenStops(name, to_stop, dist);
-                    }
-                }
-
-            }
+            AddBaseRequest(node.AsDict(), network);
         }
+        network.routing_settings = ParseRoutingSettings();
+        return network;
     }
 
-    void JsonReader::AddBusesDataToCatalogue() const {
-        for (const Node& node : GetBaseRequests()) {
-            if (node.AsDict().at("type").AsString() == "Bus") {
-                std::string name = node.AsDict().at("name").AsString();
-                std::vector<std::string> stops;
-                auto stops_node = node.AsDict().at("stops").AsArray();
-                for (const Node& stop : stops_node) {
-                    stops.emplace_back(stop.AsString());
-                }
-                TypeRoute type = { node.AsDict().at("is_roundtrip").AsBool(), handler_->GetDataBase().FindStop(stops.back()) };
-                if (!node.AsDict().at("is_roundtrip").AsBool()) {
-                    std::vector<std::string> temp = stops;
-                    stops.insert(stops.end(), std::next(temp.rbegin()), temp.rend());
-
-                }
-                const_cast<TransportCatalogue&>(handler_->GetDataBase())
-                    .AddBus(name, stops, type);
+    RoutingSettings JsonReader::ParseRoutingSettings() const {
+        RoutingSettings settings(GetRoutingSetting().at("bus_wait_time").AsDouble(), GetRoutingSetting().at("bus_velocity").AsDouble());
+        if (GetRoutingSetting().count("router_type")) {
+            settings.router_type = ParseRouterType(GetRoutingSetting().at("router_type").AsString());
+        }
+        if (GetRoutingSetting().count("router_thread_count")) {
+            const int thread_count = GetRoutingSetting().at("router_thread_count").AsInt();
+            if (thread_count < 0) {
+                throw std::invalid_argument("Router thread count should not be negative");
             }
+            settings.router_thread_count = static_cast<size_t>(thread_count);
         }
-    }
-
-    void JsonReader::AddRoutingSetting() const {
-        RoutingSettings settings(GetRoutingSetting().at("bus_wait_time").AsDouble(), GetRoutingSetting().at("bus_velocity").AsDouble());
-        const_cast<transport_router::TransportRouter&>(handler_->GetRouter()).SetRoutingSettings(settings);
+        if (GetRoutingSetting().count("router_compact_table")) {
+            settings.router_compact_table = GetRoutingSetting().at("router_compact_table").AsBool();
+        }
+        return settings;
     }
 
     svg::Color JsonReader::HandlingColor(const Node& value) const {
@@ -161,9 +356,10 @@ namespace json {
                 .EndDict();
             return answer.Build();
         }
-        auto buses_container = handler_->GetBusesByStop(name);
-        for (std::string bus_name : SortBuses(buses_container)) {
-            buses.emplace_back(Node{ bus_name });
+        const ArrayView<std::string_view> bus_names = handler_->GetBusesByStop(name);
+        buses.reserve(bus_names.size());
+        for (const std::string_view bus_name : bus_names) {
+            buses.emplace_back(Node{ std::string(bus_name) });
         }
         answer.Key("buses").Value(buses)
             .Key("request_id").Value(request_id)
@@ -182,9 +378,12 @@ namespace json {
         return answer.Build();
     }
 
-    Node JsonReader::GetRouteInfo(const std::string_view from, const std::string_view to, int request_id) {
+    Node JsonReader::GetRouteInfo(const std::string_view from, const std::string_view to,
+        std::optional<double> departure_time, int request_id) {
         Builder answer;
-        transport_router::RouteData route_data = handler_->GetRouter().CalculateRoute(from, to);
+        transport_router::RouteData route_data = departure_time
+            ? handler_->GetRouter().CalculateTimetableRoute(from, to, *departure_time)
+            : handler_->GetRouter().CalculateRoute(from, to);
 
         if (!route_data.founded) {
             answer.StartDict()
@@ -199,12 +398,12 @@ namespace json {
             Dict items_map;
             if (item.type == EdgeType::TRAVEL) {
                 items_map["type"] = std::string("Bus");
-                items_map["bus"] = item.edge_name;
+                items_map["bus"] = std::string(item.edge_name);
                 items_map["span_count"] = item.span_count;
             }
             else if (item.type == EdgeType::WAIT) {
                 items_map["type"] = std::string("Wait");
-                items_map["stop_name"] = item.edge_name;
+                items_map["stop_name"] = std::string(item.edge_name);
             }
             items_map["time"] = item.time;
             items.push_back(items_map);
@@ -217,6 +416,49 @@ namespace json {
         return answer.Build();
     }
 
+    Node JsonReader::GetRouteMatrix(const Array& from, const Array& to, int request_id) {
+        std::vector<std::string_view> stops_from;
+        stops_from.reserve(from.size());
+        for (const Node& stop : from) {
+            stops_from.push_back(stop.AsString());
+        }
+        std::vector<std::string_view> stops_to;
+        stops_to.reserve(to.size());
+        for (const Node& stop : to) {
+            stops_to.push_back(stop.AsString());
+        }
+
+        transport_router::RouteMatrix matrix = handler_->GetRouter().CalculateRouteMatrix(stops_from, stops_to);
+        Array times;
+        times.reserve(matrix.times.size());
+        for (const auto& time : matrix.times) {
+            times.push_back(time ? Node(*time) : Node(nullptr));
+        }
+
+        Builder answer;
+        answer.StartDict()
+            .Key("request_id").Value(request_id)
+            .Key("rows").Value(static_cast<int>(matrix.rows))
+            .Key("columns").Value(static_cast<int>(matrix.columns))
+            .Key("times").Value(std::move(times))
+            .EndDict();
+        return answer.Build();
+    }
+
+    Node JsonReader::GetReachable(const std::string_view from, double max_time, int request_id) {
+        Array stops;
+        for (const transport_router::ReachableStop& stop : handler_->GetRouter().CalculateReachable(from, max_time)) {
+            stops.push_back(Dict{ { "stop_name", std::string(stop.stop_name) }, { "time", stop.time } });
+        }
+
+        Builder answer;
+        answer.StartDict()
+            .Key("request_id").Value(request_id)
+            .Key("stops").Value(std::move(stops))
+            .EndDict();
+        return answer.Build();
+    }
+
     void JsonReader::ParseAndPrintStat(RequestHandler& handler, std::ostream& out) {
         Builder answer;
         answer.StartArray();
@@ -234,8 +476,20 @@ namespace json {
                 answer.Value(GetMapScheme(handler, request_id).GetValue());
             }
             if (node.AsDict().at("type").AsString() == "Route") {
+                std::optional<double> departure_time;
+                if (node.AsDict().count("departure_time")) {
+                    departure_time = node.AsDict().at("departure_time").AsDouble();
+                }
                 answer.Value(GetRouteInfo(node.AsDict().at("from").AsString(),
-                    node.AsDict().at("to").AsString(), request_id).GetValue());
+                    node.AsDict().at("to").AsString(), departure_time, request_id).GetValue());
+            }
+            if (node.AsDict().at("type").AsString() == "RouteMatrix") {
+                answer.Value(GetRouteMatrix(node.AsDict().at("from").AsArray(),
+                    node.AsDict().at("to").AsArray(), request_id).GetValue());
+            }
+            if (node.AsDict().at("type").AsString() == "Reachable") {
+                answer.Value(GetReachable(node.AsDict().at("from").AsString(),
+                    node.AsDict().at("max_time").AsDouble(), request_id).GetValue());
             }
 
         }
@@ -2,6 +2,7 @@
 
 #include <memory>
 #include <sstream>
+#include <string_view>
 
 #include "../json/json_builder.h"
 #include "request_handler.h"
@@ -15,23 +16,32 @@ namespace json {
 
         void LoadHandler(RequestHandler handler);
         void LoadJson(std::istream& input);
+        void LoadJson(std::string_view input);
+        //  : base_requests          ,
+        //      LoadJson
+        NetworkDescription LoadJsonStreaming(std::istream& input);
+        NetworkDescription LoadJsonStreaming(std::string_view input);
         const Array& GetBaseRequests()  const;
         const Array& GetStatRequests()  const;
         const Dict& GetRenderSetting()  const;
         const Dict& GetRoutingSetting() const;
-        void AddStopsDataToCatalogue()  const;
-        void AddBusesDataToCatalogue()  const;
-        void AddRoutingSetting()        const;
+        NetworkDescription ParseNetwork() const;
+        RoutingSettings ParseRoutingSettings() const;
         svg::Color HandlingColor(const Node& value) const;
         void ParseRenderSettings(renderer::MapRenderer& renderer) const;
         Node GetStatForBusRequest(const std::string_view name, int request_id);
         Node GetStatForStopRequest(const std::string_view name, int request_id);
         Node GetMapScheme(RequestHandler& handler, int request_id);
-        Node GetRouteInfo(const std::string_view from, const std::string_view to, int request_id);
+        Node GetRouteInfo(const std::string_view from, const std::string_view to,
+            std::optional<double> departure_time, int request_id);
+        Node GetRouteMatrix(const Array& from, const Array& to, int request_id);
+        Node GetReachable(const std::string_view from, double max_time, int request_id);
         void ParseAndPrintStat(RequestHandler& handler, std::ostream& out);
 
     private:
         std::unique_ptr<Document> document_;
+
+        void SetStreamedDocument(Dict root, NetworkDescription& network);
         std::unique_ptr<RequestHandler> handler_;
     };
 
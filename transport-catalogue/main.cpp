@@ -1,28 +1,106 @@
 #include <iostream>
 #include <fstream>
+#include <optional>
 #include <sstream>
+#include <string>
+#include <string_view>
 
 #include "json_reader.h"
 
 using namespace std;
 using namespace json;
 
-int main() {
-    TransportCatalogue catalogue;
-    renderer::MapRenderer renderer;
-    transport_router::TransportRouter router(catalogue);
-    RequestHandler handler(catalogue, renderer, router);
+namespace {
+
+    void PrintUsage(ostream& stream) {
+        stream << "Usage: transport_catalogue [--input <json>] [make_base <image>"sv
+               << " | make_routing <image> <routing image>"sv
+               << " | process_requests <image> [<routing image>]]\n"sv;
+    }
+
+    void ProcessRequests(JsonReader& reader, SnapshotStore& store) {
+        renderer::MapRenderer renderer;
+        reader.ParseRenderSettings(renderer);
+        RequestHandler handler(store.GetSnapshot(), renderer);
+        reader.LoadHandler(handler);
+
+        ostream& out = cout;
+        reader.ParseAndPrintStat(handler, out);
+    }
+
+    string ReadAll(istream& input) {
+        string data;
+        char chunk[1 << 16];
+        while (input.read(chunk, sizeof(chunk)) || input.gcount() > 0) {
+            data.append(chunk, static_cast<size_t>(input.gcount()));
+        }
+        return data;
+    }
+
+    template <typename Writer>
+    bool WriteFile(const char* path, Writer writer) {
+        ofstream output(path, ios::binary);
+        writer(output);
+        if (!output) {
+            cerr << "Cannot write "sv << path << '\n';
+            return false;
+        }
+        return true;
+    }
+
+}  // namespace
+
+//         JSON.
+// make_base     , make_routing -    ,
+// process_requests      .
+// JSON   :   --input   , stdin  
+int main(int argc, char* argv[]) {
     JsonReader reader;
-    reader.LoadHandler(handler);
+    SnapshotStore store;
+
+    const char* input_path = nullptr;
+    if (argc >= 3 && argv[1] == "--input"sv) {
+        input_path = argv[2];
+        argc -= 2;
+        argv += 2;
+    }
+    optional<MappedFile> input_file;
+    string input_data;
+    const auto read_input = [&]() -> string_view {
+        if (input_path != nullptr) {
+            input_file.emplace(input_path);
+            return { input_file->GetData(), input_file->GetSize() };
+        }
+        input_data = ReadAll(cin);
+        return input_data;
+    };
 
-    istream& input = cin;
-    reader.LoadJson(input);
+    if (argc == 1) {
+        store.Publish(reader.LoadJsonStreaming(read_input()), false);
+        ProcessRequests(reader, store);
+        return 0;
+    }
 
-    reader.AddStopsDataToCatalogue();
-    reader.AddBusesDataToCatalogue();
-    reader.AddRoutingSetting();
-    reader.ParseRenderSettings(renderer);
+    const string_view mode(argv[1]);
+    if (mode == "make_base"sv && argc == 3) {
+        const SnapshotPtr snapshot = store.Publish(reader.LoadJsonStreaming(read_input()), false);
+        return WriteFile(argv[2], [&](ostream& output) {
+            WriteCatalogueImage(snapshot->GetCatalogue(), reader.ParseRoutingSettings(), output);
+            }) ? 0 : 1;
+    }
+    if (mode == "make_routing"sv && argc == 4) {
+        const SnapshotPtr snapshot = store.Publish(CatalogueImage::Open(argv[2]), true);
+        return WriteFile(argv[3], [&](ostream& output) {
+            snapshot->GetRouter().WriteRoutingImage(output);
+            }) ? 0 : 1;
+    }
+    if (mode == "process_requests"sv && (argc == 3 || argc == 4)) {
+        reader.LoadJson(read_input());
+        store.Publish(CatalogueImage::Open(argv[2]), false, argc == 4 ? RoutingImage::Open(argv[3]) : nullptr);
+        ProcessRequests(reader, store);
+        return 0;
+    }
 
-    ostream& out = cout;
-    reader.ParseAndPrintStat(handler, out);   
-}
\ No newline at end of file
+    PrintUsage(cerr);
+    return 1;
+}
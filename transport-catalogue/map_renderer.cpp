@@ -28,7 +28,7 @@ namespace renderer {
         return { backlayer, text };
     }
 
-    void MapRenderer::RenderStopsSymbols(const std::map<std::string, Stop*> stops,
+    void MapRenderer::RenderStopsSymbols(const std::map<std::string, const Stop*> stops,
         const SphereProjector& projector, svg::Document& doc) const {
 
         for (auto [name, stop] : stops) {
@@ -40,8 +40,8 @@ namespace renderer {
         }
     }
 
-    void MapRenderer::RenderRouteLine(const Bus& bus, const SphereProjector& projector, svg::Document& doc,
-        svg::Color route_color, std::map<std::string, Stop*>& unique_sort_stops) const {
+    void MapRenderer::RenderRouteLine(const std::vector<const Stop*>& stops, const SphereProjector& projector, svg::Document& doc,
+        svg::Color route_color, std::map<std::string, const Stop*>& unique_sort_stops) const {
 
         svg::Polyline polyline;
         polyline.SetStrokeColor(route_color)
@@ -50,9 +50,9 @@ namespace renderer {
                 .SetStrokeLineJoin(svg::StrokeLineJoin::ROUND)
                 .SetFillColor(svg::NoneColor);
 
-        for (const auto& stop : bus.stops) {
+        for (const Stop* stop : stops) {
             polyline.AddPoint(projector(stop->coordinates));
-            unique_sort_stops[stop->stop_name] = stop;
+            unique_sort_stops[std::string(stop->stop_name)] = stop;
         }
         doc.Add(polyline);
     }
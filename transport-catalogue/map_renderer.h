@@ -100,11 +100,11 @@ namespace renderer {
         std::pair<svg::Text, svg::Text> RenderTextLabels(svg::Point point, svg::Point offset,
             std::string data, svg::Color color, double font_size, std::string font_weight) const;
 
-        void RenderStopsSymbols(const std::map<std::string, Stop*> stops,
+        void RenderStopsSymbols(const std::map<std::string, const Stop*> stops,
             const SphereProjector& projector, svg::Document& doc) const;
 
-        void RenderRouteLine(const Bus& bus, const SphereProjector& projector, svg::Document& doc,
-            svg::Color route_color, std::map<std::string, Stop*>& unique_sort_stops) const;
+        void RenderRouteLine(const std::vector<const Stop*>& stops, const SphereProjector& projector, svg::Document& doc,
+            svg::Color route_color, std::map<std::string, const Stop*>& unique_sort_stops) const;
         
     };
 
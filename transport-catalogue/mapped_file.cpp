@@ -0,0 +1,58 @@
+#include "mapped_file.h"
+
+#include <fstream>
+
+#if defined(_WIN32)
+#define MAPPED_FILE_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#ifdef MAPPED_FILE_NO_MMAP
+    std::ifstream input(path, std::ios::binary | std::ios::ate);
+    if (!input) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    size_ = static_cast<size_t>(input.tellg());
+    buffer_ = std::make_unique<uint64_t[]>((size_ + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    input.seekg(0);
+    input.read(reinterpret_cast<char*>(buffer_.get()), static_cast<std::streamsize>(size_));
+    if (!input) {
+        throw std::runtime_error("Cannot read " + path);
+    }
+    data_ = reinterpret_cast<const char*>(buffer_.get());
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat " + path);
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ == 0) {
+        close(fd);
+        return;
+    }
+    void* mapping = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Cannot map " + path);
+    }
+    data_ = static_cast<const char*>(mapping);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifndef MAPPED_FILE_NO_MMAP
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+#endif
+}
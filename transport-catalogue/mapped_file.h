@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "array_view.h"
+
+// ,      .  : ,
+//   ,   .  mmap     
+class MappedFile {
+public:
+    //  std::runtime_error,    
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    const char* GetData() const { return data_; }
+    size_t GetSize() const { return size_; }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    std::unique_ptr<uint64_t[]> buffer_;
+};
+
+//  :  ,   IMAGE_ALIGNMENT,     
+struct ImageSection {
+    uint64_t offset;
+    uint64_t size;  //  
+};
+
+constexpr size_t IMAGE_ALIGNMENT = 8;
+
+inline void CheckImage(bool condition, const char* message) {
+    if (!condition) {
+        throw std::runtime_error(std::string("Invalid image: ") + message);
+    }
+}
+
+//  :     ,    ,
+//   -    ,     
+class ImageLayout {
+public:
+    explicit ImageLayout(size_t header_size)
+        : header_size_(header_size)
+        , size_(header_size) {
+    }
+
+    // values    Write()
+    void AddSection(const void* values, uint64_t bytes) {
+        const uint64_t offset = (size_ + IMAGE_ALIGNMENT - 1) / IMAGE_ALIGNMENT * IMAGE_ALIGNMENT;
+        sources_.push_back(static_cast<const char*>(values));
+        sections_.push_back({ offset, bytes });
+        size_ = offset + bytes;
+    }
+
+    template <typename T>
+    void AddSection(ArrayView<T> values) {
+        AddSection(values.data(), values.size() * sizeof(T));
+    }
+
+    template <typename T>
+    void AddSection(const std::vector<T>& values) {
+        AddSection(ArrayView<T>(values));
+    }
+
+    const std::vector<ImageSection>& GetSections() const { return sections_; }
+    uint64_t GetSize() const { return size_; }
+
+    // header -   header_size    
+    void Write(std::ostream& output, const void* header) const {
+        static constexpr char PADDING[IMAGE_ALIGNMENT] = {};
+        output.write(static_cast<const char*>(header), static_cast<std::streamsize>(header_size_));
+        uint64_t position = header_size_;
+        for (size_t section = 0; section < sections_.size(); ++section) {
+            const ImageSection& image_section = sections_[section];
+            output.write(PADDING, static_cast<std::streamsize>(image_section.offset - position));
+            output.write(sources_[section], static_cast<std::streamsize>(image_section.size));
+            position = image_section.offset + image_section.size;
+        }
+    }
+
+private:
+    size_t header_size_;
+    uint64_t size_;
+    std::vector<const char*> sources_;
+    std::vector<ImageSection> sections_;
+};
+
+// ,     ,       
+inline void CheckImageSection(const ImageSection& section, size_t file_size, size_t element_size) {
+    CheckImage(section.offset % IMAGE_ALIGNMENT == 0, "misaligned section");
+    CheckImage(section.offset <= file_size && section.size <= file_size - section.offset, "section is out of file");
+    CheckImage(section.size % element_size == 0, "section size is not a multiple of its element");
+}
+
+template <typename T>
+ArrayView<T> GetImageSection(const char* data, const ImageSection& section) {
+    const T* first = reinterpret_cast<const T*>(data + section.offset);
+    return { first, first + section.size / sizeof(T) };
+}
@@ -0,0 +1,160 @@
+#include "raptor_router.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace transport_router {
+
+	namespace {
+		constexpr double UNREACHED = std::numeric_limits<double>::infinity();
+		constexpr size_t NO_POSITION = std::numeric_limits<size_t>::max();
+	}
+
+	RaptorRouter::RaptorRouter(const TransportCatalogue& db, double bus_wait_time, double velocity_factor)
+		: bus_wait_time_(bus_wait_time)
+		, velocity_factor_(velocity_factor) {
+		stop_lines_.resize(db.GetAllStopsCount());
+
+		lines_.reserve(db.GetAllBuses().size());
+		for (const Bus& bus : db.GetAllBuses()) {
+			Line line{ &bus, {}, db.GetBusPrefixDistances(bus.id) };
+			line.stops.reserve(bus.stops.size());
+			for (size_t position = 0; position < bus.stops.size(); ++position) {
+				const StopId stop_index = bus.stops[position];
+				line.stops.push_back(stop_index);
+				stop_lines_[stop_index].push_back({ lines_.size(), position });
+			}
+			lines_.push_back(std::move(line));
+		}
+	}
+
+	std::optional<RaptorRouter::Journey> RaptorRouter::BuildRoute(StopId from, StopId to) const {
+		const size_t stop_from = from;
+		const size_t stop_to = to;
+		const size_t stop_count = stop_lines_.size();
+		if (stop_to >= stop_count) {
+			throw std::out_of_range("Stop is out of range");
+		}
+
+		std::vector<double> arrivals(stop_count, UNREACHED);
+		std::vector<Label> labels(stop_count);
+		Scan(stop_from, stop_to, UNREACHED, arrivals, labels);
+
+		if (arrivals[stop_to] == UNREACHED) {
+			return std::nullopt;
+		}
+
+		Journey journey;
+		for (size_t stop = stop_to; stop != stop_from;) {
+			if (journey.rides.size() > stop_count) {
+				throw std::logic_error("Journey reconstruction failed");
+			}
+			const Label& label = labels[stop];
+			const Line& line = lines_[label.line];
+			journey.rides.push_back({ line.bus, label.board_position, label.alight_position,
+				bus_wait_time_, GetRideTime(line, label.board_position, label.alight_position) });
+			stop = line.stops[label.board_position];
+		}
+		std::reverse(journey.rides.begin(), journey.rides.end());
+		for (const Ride& ride : journey.rides) {
+			journey.total_time += ride.wait_time + ride.ride_time;
+		}
+		return journey;
+	}
+
+	std::vector<std::optional<double>> RaptorRouter::BuildTimes(StopId from, const std::vector<StopId>& targets) const {
+		const size_t stop_count = stop_lines_.size();
+		std::vector<double> arrivals(stop_count, UNREACHED);
+		std::vector<Label> labels(stop_count);
+		Scan(from, NO_POSITION, UNREACHED, arrivals, labels);
+
+		std::vector<std::optional<double>> times;
+		times.reserve(targets.size());
+		for (const StopId target : targets) {
+			const double arrival = arrivals.at(target);
+			times.push_back(arrival == UNREACHED ? std::nullopt : std::optional<double>(arrival));
+		}
+		return times;
+	}
+
+	std::vector<std::pair<StopId, double>> RaptorRouter::BuildReachable(StopId from, double max_time) const {
+		const size_t stop_count = stop_lines_.size();
+		std::vector<double> arrivals(stop_count, UNREACHED);
+		std::vector<Label> labels(stop_count);
+		Scan(from, NO_POSITION, max_time, arrivals, labels);
+
+		std::vector<std::pair<StopId, double>> reachable;
+		for (size_t stop = 0; stop < stop_count; ++stop) {
+			if (arrivals[stop] != UNREACHED) {
+				reachable.emplace_back(static_cast<StopId>(stop), arrivals[stop]);
+			}
+		}
+		return reachable;
+	}
+
+	// stop_to == NO_POSITION -    ,        max_arrival
+	void RaptorRouter::Scan(size_t stop_from, size_t stop_to, double max_arrival,
+		std::vector<double>& arrivals, std::vector<Label>& labels) const {
+		const size_t stop_count = stop_lines_.size();
+		std::vector<bool> marked(stop_count, false);
+		if (stop_from >= stop_count) {
+			throw std::out_of_range("Stop is out of range");
+		}
+		std::vector<size_t> marked_stops{ stop_from };
+		std::vector<size_t> line_starts(lines_.size(), NO_POSITION);
+		std::vector<size_t> scanned_lines;
+		arrivals[stop_from] = 0.0;
+
+		//   -     
+		while (!marked_stops.empty()) {
+			const std::vector<double> previous_arrivals = arrivals;
+			for (const size_t stop : marked_stops) {
+				marked[stop] = false;
+				for (const LineStop& line_stop : stop_lines_[stop]) {
+					if (line_starts[line_stop.line] == NO_POSITION) {
+						scanned_lines.push_back(line_stop.line);
+					}
+					line_starts[line_stop.line] = std::min(line_starts[line_stop.line], line_stop.position);
+				}
+			}
+			marked_stops.clear();
+
+			for (const size_t line_index : scanned_lines) {
+				const Line& line = lines_[line_index];
+				size_t board_position = NO_POSITION;
+				double board_key = UNREACHED;
+				for (size_t position = line_starts[line_index]; position < line.stops.size(); ++position) {
+					const size_t stop = line.stops[position];
+					if (board_position != NO_POSITION) {
+						const double arrival = previous_arrivals[line.stops[board_position]] + bus_wait_time_
+							+ GetRideTime(line, board_position, position);
+						const double target_arrival = stop_to == NO_POSITION ? UNREACHED : arrivals[stop_to];
+						if (arrival <= max_arrival && arrival < std::min(arrivals[stop], target_arrival)) {
+							arrivals[stop] = arrival;
+							labels[stop] = { line_index, board_position, position };
+							if (!marked[stop]) {
+								marked[stop] = true;
+								marked_stops.push_back(stop);
+							}
+						}
+					}
+					if (previous_arrivals[stop] != UNREACHED) {
+						const double key = previous_arrivals[stop] - line.distances[position] / velocity_factor_;
+						if (key < board_key) {
+							board_key = key;
+							board_position = position;
+						}
+					}
+				}
+				line_starts[line_index] = NO_POSITION;
+			}
+			scanned_lines.clear();
+		}
+	}
+
+	double RaptorRouter::GetRideTime(const Line& line, size_t board_position, size_t alight_position) const {
+		return (line.distances[alight_position] - line.distances[board_position]) / velocity_factor_;
+	}
+
+} // namespace transport_router
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "transport_catalogue.h"
+
+namespace transport_router {
+
+	class RaptorRouter {
+	public:
+		struct Ride {
+			const Bus* bus;
+			size_t board_position;
+			size_t alight_position;
+			double wait_time;
+			double ride_time;
+		};
+
+		struct Journey {
+			double total_time = 0.0;
+			std::vector<Ride> rides;
+		};
+
+		RaptorRouter(const TransportCatalogue& db, double bus_wait_time, double velocity_factor);
+
+		std::optional<Journey> BuildRoute(StopId from, StopId to) const;
+		std::vector<std::optional<double>> BuildTimes(StopId from, const std::vector<StopId>& targets) const;
+		std::vector<std::pair<StopId, double>> BuildReachable(StopId from, double max_time) const;
+
+	private:
+		struct Line {
+			const Bus* bus;
+			std::vector<size_t> stops;
+			ArrayView<double> distances;
+		};
+
+		struct LineStop {
+			size_t line;
+			size_t position;
+		};
+
+		struct Label {
+			size_t line;
+			size_t board_position;
+			size_t alight_position;
+		};
+
+		double bus_wait_time_;
+		double velocity_factor_;
+		std::vector<Line> lines_;
+		std::vector<std::vector<LineStop>> stop_lines_;
+
+		void Scan(size_t stop_from, size_t stop_to, double max_arrival,
+			std::vector<double>& arrivals, std::vector<Label>& labels) const;
+		double GetRideTime(const Line& line, size_t board_position, size_t alight_position) const;
+	};
+
+} // namespace transport_router
@@ -2,18 +2,17 @@
 
 #include "request_handler.h"
 
-static std::deque<Bus> GetSortedCopyOfBuses(const std::deque<Bus>* buses) {
-    std::deque<Bus> copy_buses(*buses);
+static std::deque<Bus> GetSortedCopyOfBuses(const std::vector<Bus>* buses) {
+    std::deque<Bus> copy_buses(buses->begin(), buses->end());
     std::sort(copy_buses.begin(), copy_buses.end(),
         [](auto& lhs, auto& rhs) { return lhs.bus_name < rhs.bus_name; });
     return copy_buses;
 }
 
-RequestHandler::RequestHandler(const TransportCatalogue& db, const renderer::MapRenderer& renderer,
-        transport_router::TransportRouter& router)
-    : db_(db)
-    , renderer_(renderer)
-    , router_(router) {
+RequestHandler::RequestHandler(SnapshotPtr snapshot, const renderer::MapRenderer& renderer)
+    : snapshot_(std::move(snapshot))
+    , db_(snapshot_->GetCatalogue())
+    , renderer_(renderer) {
 }
 
 const TransportCatalogue& RequestHandler::GetDataBase() {
@@ -26,41 +25,28 @@ std::optional<BusStat> RequestHandler::GetBusStat(const std::string_view& bus_na
         return std::nullopt;
     }
 
-    std::unordered_set<std::string_view> unique;
-    for (Stop* stop : bus_ptr->stops) {
-        unique.emplace(stop->stop_name);
-    }
-
-    double length(0.0);
-    for (size_t i = 0; i < bus_ptr->stops.size() - 1; ++i) {
-        auto from = bus_ptr->stops[i];
-        auto to   = bus_ptr->stops[i + 1];
-        length   += db_.GetDistance(from, to).meters;
-    }
-
-    double curvature(0.0);
-    curvature += geo::ComputeCurvature(bus_ptr, length);
-    BusStat stat = { bus_ptr->stops.size(), unique.size(), length, curvature };
-    return std::make_optional(stat);
+    return std::make_optional(db_.GetBusStat(bus_ptr->id));
 }
 
-const std::unordered_set<Bus*>* RequestHandler::GetBusesByStop(const std::string_view& stop_name) const {
-    return db_.FindBusesForStop(stop_name);
+ArrayView<std::string_view> RequestHandler::GetBusesByStop(const std::string_view& stop_name) const {
+    const Stop* stop = db_.FindStop(stop_name);
+    return stop == nullptr ? ArrayView<std::string_view>{} : db_.GetStopBuses(stop->id);
 }
 
 const renderer::SphereProjector RequestHandler::GetProjector(const std::deque<Bus>* buses) const {
+    const geo::CoordinateArrays& stop_coordinates = db_.GetStopCoordinates();
     std::vector<geo::Coordinates> coords;
     for (const Bus& bus : *buses) {
-        for (const Stop* stop : bus.stops)
-            coords.emplace_back(stop->coordinates);
+        for (StopId stop : bus.stops)
+            coords.emplace_back(stop_coordinates.Get(stop));
     }
     renderer::SphereProjector projector(coords.begin(), coords.end()
                                        , renderer_.width, renderer_.height, renderer_.padding);
     return projector;
 }
 
-transport_router::TransportRouter& RequestHandler::GetRouter() {
-    return router_;
+const transport_router::TransportRouter& RequestHandler::GetRouter() {
+    return snapshot_->GetRouter();
 }
 
 svg::Document RequestHandler::RenderMap() const {  
@@ -69,18 +55,23 @@ svg::Document RequestHandler::RenderMap() const {
     std::vector<geo::Coordinates> coords;
     renderer::SphereProjector projector = GetProjector(&all_buses);
     std::vector<std::pair<svg::Text, svg::Text>> labels;
-    std::map<std::string, Stop*> unique_sort_stops;
+    std::map<std::string, const Stop*> unique_sort_stops;
     int bus_number = 0;
     for (const Bus& bus : all_buses) {
+        std::vector<const Stop*> bus_stops;
+        bus_stops.reserve(bus.stops.size());
+        for (StopId stop : bus.stops) {
+            bus_stops.push_back(&db_.GetStop(stop));
+        }
         auto route_color = renderer_.color_palette[bus_number % renderer_.color_palette.size()];
-        renderer_.RenderRouteLine(bus, projector, doc, route_color, unique_sort_stops);
+        renderer_.RenderRouteLine(bus_stops, projector, doc, route_color, unique_sort_stops);
 
-        labels.emplace_back(renderer_.RenderTextLabels(projector(bus.stops.front()->coordinates),
-            renderer_.bus_label_offset, bus.bus_name, route_color, renderer_.bus_label_font_size, "bold"));
+        labels.emplace_back(renderer_.RenderTextLabels(projector(bus_stops.front()->coordinates),
+            renderer_.bus_label_offset, std::string(bus.bus_name), route_color, renderer_.bus_label_font_size, "bold"));
 
         if (!bus.is_roundtrip.first && bus.stops.front() != bus.is_roundtrip.second) {
-            labels.emplace_back(renderer_.RenderTextLabels(projector(bus.is_roundtrip.second->coordinates),
-                renderer_.bus_label_offset, bus.bus_name, route_color, renderer_.bus_label_font_size, "bold"));
+            labels.emplace_back(renderer_.RenderTextLabels(projector(db_.GetStop(bus.is_roundtrip.second).coordinates),
+                renderer_.bus_label_offset, std::string(bus.bus_name), route_color, renderer_.bus_label_font_size, "bold"));
         }
         ++bus_number;
     }
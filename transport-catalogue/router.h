@@ -6,8 +6,11 @@
 #include <cassert>
 #include <cstdint>
 #include <iterator>
+#include <limits>
 #include <optional>
 #include <stdexcept>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -15,103 +18,245 @@
 namespace graph {
 
     template <typename Weight>
-    class Router {
-    private:
-        using Graph = DirectedWeightedGraph<Weight>;
-
+    class RouteBuilder {
     public:
-        explicit Router(const Graph& graph);
-
         struct RouteInfo {
             Weight weight;
             std::vector<EdgeId> edges;
         };
 
-        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
+        virtual ~RouteBuilder() = default;
+
+        virtual std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const = 0;
+
+        //    from    targets   
+        virtual std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const {
+            std::vector<std::optional<Weight>> weights;
+            weights.reserve(targets.size());
+            for (const VertexId to : targets) {
+                const auto route = BuildRoute(from, to);
+                weights.push_back(route ? std::optional<Weight>(route->weight) : std::nullopt);
+            }
+            return weights;
+        }
+    };
+
+    // TableWeight  TableEdgeId    : Router<double, float, uint32_t>
+    //  8      16
+    template <typename Weight, typename TableWeight = Weight, typename TableEdgeId = EdgeId>
+    class Router : public RouteBuilder<Weight> {
+        static_assert(std::numeric_limits<TableWeight>::has_infinity, "Table weight should have an infinity value");
+        static_assert(std::is_unsigned_v<TableEdgeId>, "Table edge id should be unsigned");
 
     private:
+        using Graph = DirectedWeightedGraph<Weight>;
+
+    public:
+        using typename RouteBuilder<Weight>::RouteInfo;
+
         struct RouteInternalData {
-            Weight weight;
-            std::optional<EdgeId> prev_edge;
+            TableWeight weight;
+            TableEdgeId prev_edge;
         };
-        using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+
+        explicit Router(const Graph& graph, size_t thread_count = 1);
+        //    vertex_count * vertex_count ,    ;
+        //     
+        Router(const Graph& graph, const RouteInternalData* table);
+
+        std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const override;
+        std::vector<std::optional<Weight>> BuildWeights(VertexId from, const std::vector<VertexId>& targets) const override;
+
+        const RouteInternalData* GetTable() const {
+            return table_;
+        }
+
+    private:
+        using RoutesInternalData = std::vector<RouteInternalData>;
+
+        RouteInternalData& GetRouteInternalData(VertexId vertex_from, VertexId vertex_to) {
+            return routes_internal_data_[vertex_from * vertex_count_ + vertex_to];
+        }
+
+        const RouteInternalData& GetRouteInternalData(VertexId vertex_from, VertexId vertex_to) const {
+            return table_[vertex_from * vertex_count_ + vertex_to];
+        }
 
         void InitializeRoutesInternalData(const Graph& graph) {
-            const size_t vertex_count = graph.GetVertexCount();
-            for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-                routes_internal_data_[vertex][vertex] = RouteInternalData{ ZERO_WEIGHT, std::nullopt };
-                for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
-                    const auto& edge = graph.GetEdge(edge_id);
-                    if (edge.weight < ZERO_WEIGHT) {
+            for (VertexId vertex = 0; vertex < vertex_count_; ++vertex) {
+                GetRouteInternalData(vertex, vertex) = RouteInternalData{ TableWeight{}, NO_EDGE };
+                graph.ForEachIncidentEdge(vertex, [this, vertex](EdgeId edge_id, VertexId vertex_to, Weight edge_weight) {
+                    if (edge_weight < ZERO_WEIGHT) {
                         throw std::domain_error("Edges' weights should be non-negative");
                     }
-                    auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                    if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                        route_internal_data = RouteInternalData{ edge.weight, edge_id };
+                    auto& route_internal_data = GetRouteInternalData(vertex, vertex_to);
+                    const TableWeight table_weight = static_cast<TableWeight>(edge_weight);
+                    if (route_internal_data.weight > table_weight) {
+                        route_internal_data = RouteInternalData{ table_weight, static_cast<TableEdgeId>(edge_id) };
                     }
-                }
+                    });
             }
         }
 
-        void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-            const RouteInternalData& route_to) {
-            auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-            const Weight candidate_weight = route_from.weight + route_to.weight;
-            if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-                route_relaxing = { candidate_weight,
-                                  route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge };
-            }
-        }
+        void RelaxBlock(size_t block_from, size_t block_to, size_t block_through) {
+            const VertexId through_begin = block_through * BLOCK_SIZE;
+            const VertexId through_end = std::min(through_begin + BLOCK_SIZE, vertex_count_);
+            const VertexId from_begin = block_from * BLOCK_SIZE;
+            const VertexId from_end = std::min(from_begin + BLOCK_SIZE, vertex_count_);
+            const VertexId to_begin = block_to * BLOCK_SIZE;
+            const VertexId to_end = std::min(to_begin + BLOCK_SIZE, vertex_count_);
 
-        void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-            for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-                if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                    for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                        if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                            RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
+            for (VertexId vertex_through = through_begin; vertex_through < through_end; ++vertex_through) {
+                const RouteInternalData* routes_to = &GetRouteInternalData(vertex_through, 0);
+                for (VertexId vertex_from = from_begin; vertex_from < from_end; ++vertex_from) {
+                    const RouteInternalData route_from = GetRouteInternalData(vertex_from, vertex_through);
+                    if (route_from.weight == UNREACHABLE) {
+                        continue;
+                    }
+                    RouteInternalData* routes_relaxing = &GetRouteInternalData(vertex_from, 0);
+                    for (VertexId vertex_to = to_begin; vertex_to < to_end; ++vertex_to) {
+                        const RouteInternalData& route_to = routes_to[vertex_to];
+                        const TableWeight candidate_weight = route_from.weight + route_to.weight;
+                        if (candidate_weight < routes_relaxing[vertex_to].weight) {
+                            routes_relaxing[vertex_to] = { candidate_weight,
+                                route_to.prev_edge != NO_EDGE ? route_to.prev_edge : route_from.prev_edge };
                         }
                     }
                 }
             }
         }
 
+        template <typename Task>
+        void RunInParallel(size_t task_count, Task task) const {
+            const size_t thread_count = std::min(thread_count_, task_count);
+            if (thread_count <= 1) {
+                for (size_t task_id = 0; task_id < task_count; ++task_id) {
+                    task(task_id);
+                }
+                return;
+            }
+            std::vector<std::thread> threads;
+            threads.reserve(thread_count);
+            for (size_t thread_id = 0; thread_id < thread_count; ++thread_id) {
+                threads.emplace_back([thread_id, thread_count, task_count, &task] {
+                    for (size_t task_id = thread_id; task_id < task_count; task_id += thread_count) {
+                        task(task_id);
+                    }
+                    });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+
+        void RelaxRoutesInternalDataThroughBlock(size_t block_count, size_t block_through) {
+            RelaxBlock(block_through, block_through, block_through);
+
+            RunInParallel(block_count, [this, block_through](size_t block) {
+                if (block != block_through) {
+                    RelaxBlock(block_through, block, block_through);
+                    RelaxBlock(block, block_through, block_through);
+                }
+                });
+
+            RunInParallel(block_count * block_count, [this, block_count, block_through](size_t task_id) {
+                const size_t block_from = task_id / block_count;
+                const size_t block_to = task_id % block_count;
+                if (block_from != block_through && block_to != block_through) {
+                    RelaxBlock(block_from, block_to, block_through);
+                }
+                });
+        }
+
         static constexpr Weight ZERO_WEIGHT{};
+        static constexpr TableWeight UNREACHABLE = std::numeric_limits<TableWeight>::infinity();
+        static constexpr TableEdgeId NO_EDGE = std::numeric_limits<TableEdgeId>::max();
+        static constexpr size_t BLOCK_SIZE = 64;
         const Graph& graph_;
+        const size_t vertex_count_;
+        const size_t thread_count_;
         RoutesInternalData routes_internal_data_;
+        //   : routes_internal_data_  
+        const RouteInternalData* table_ = nullptr;
     };
 
-    template <typename Weight>
-    Router<Weight>::Router(const Graph& graph)
+    template <typename Weight, typename TableWeight, typename TableEdgeId>
+    Router<Weight, TableWeight, TableEdgeId>::Router(const Graph& graph, size_t thread_count)
         : graph_(graph)
-        , routes_internal_data_(graph.GetVertexCount(),
-            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+        , vertex_count_(graph.GetVertexCount())
+        , thread_count_(thread_count > 0 ? thread_count : std::max<size_t>(std::thread::hardware_concurrency(), 1))
+        , routes_internal_data_(vertex_count_ * vertex_count_, RouteInternalData{ UNREACHABLE, NO_EDGE })
     {
+        if (graph.GetEdgeCount() >= static_cast<size_t>(NO_EDGE)) {
+            throw std::length_error("Too many edges for the route table");
+        }
         InitializeRoutesInternalData(graph);
 
-        const size_t vertex_count = graph.GetVertexCount();
-        for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-            RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+        const size_t block_count = (vertex_count_ + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        for (size_t block_through = 0; block_through < block_count; ++block_through) {
+            RelaxRoutesInternalDataThroughBlock(block_count, block_through);
         }
+        table_ = routes_internal_data_.data();
     }
 
-    template <typename Weight>
-    std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
-        VertexId to) const {
-        const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-        if (!route_internal_data) {
+    template <typename Weight, typename TableWeight, typename TableEdgeId>
+    Router<Weight, TableWeight, TableEdgeId>::Router(const Graph& graph, const RouteInternalData* table)
+        : graph_(graph)
+        , vertex_count_(graph.GetVertexCount())
+        , thread_count_(1)
+        , table_(table)
+    {
+        if (graph.GetEdgeCount() >= static_cast<size_t>(NO_EDGE)) {
+            throw std::length_error("Too many edges for the route table");
+        }
+    }
+
+    template <typename Weight, typename TableWeight, typename TableEdgeId>
+    std::optional<typename Router<Weight, TableWeight, TableEdgeId>::RouteInfo> Router<Weight, TableWeight, TableEdgeId>::BuildRoute(
+        VertexId from, VertexId to) const {
+        if (from >= vertex_count_ || to >= vertex_count_) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+        const auto& route_internal_data = GetRouteInternalData(from, to);
+        if (route_internal_data.weight == UNREACHABLE) {
             return std::nullopt;
         }
-        const Weight weight = route_internal_data->weight;
+        const Weight weight = static_cast<Weight>(route_internal_data.weight);
         std::vector<EdgeId> edges;
-        for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-            edge_id;
-            edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
+        for (TableEdgeId edge_id = route_internal_data.prev_edge;
+            edge_id != NO_EDGE;
+            edge_id = GetRouteInternalData(from, graph_.GetEdge(edge_id).from).prev_edge)
         {
-            edges.push_back(*edge_id);
+            if (edges.size() >= vertex_count_) {
+                throw std::logic_error("Route reconstruction failed");
+            }
+            //     
+            if (edge_id >= graph_.GetEdgeCount()) {
+                throw std::runtime_error("Route table refers to a missing edge");
+            }
+            edges.push_back(edge_id);
         }
         std::reverse(edges.begin(), edges.end());
 
         return RouteInfo{ weight, std::move(edges) };
     }
 
+    template <typename Weight, typename TableWeight, typename TableEdgeId>
+    std::vector<std::optional<Weight>> Router<Weight, TableWeight, TableEdgeId>::BuildWeights(VertexId from,
+        const std::vector<VertexId>& targets) const {
+        if (from >= vertex_count_) {
+            throw std::out_of_range("Vertex is out of range");
+        }
+        std::vector<std::optional<Weight>> weights;
+        weights.reserve(targets.size());
+        for (const VertexId to : targets) {
+            if (to >= vertex_count_) {
+                throw std::out_of_range("Vertex is out of range");
+            }
+            const TableWeight weight = GetRouteInternalData(from, to).weight;
+            weights.push_back(weight == UNREACHABLE ? std::nullopt : std::optional<Weight>(static_cast<Weight>(weight)));
+        }
+        return weights;
+    }
+
 }  // namespace graph
\ No newline at end of file
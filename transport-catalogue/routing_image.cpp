@@ -0,0 +1,320 @@
+#include "routing_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include "transport_catalogue.h"
+
+namespace {
+
+    enum Section : size_t {
+        EDGE_FROM,
+        EDGE_TO,
+        EDGE_WEIGHT,
+        EDGE_OWNER,
+        EDGE_SPAN_COUNT,
+        EDGE_TYPE,
+        ROUTE_TABLE,
+        HIERARCHY_EDGE_FROM,
+        HIERARCHY_EDGE_TO,
+        HIERARCHY_EDGE_WEIGHT,
+        HIERARCHY_EDGE_ORIGINAL,
+        HIERARCHY_EDGE_FIRST_CHILD,
+        HIERARCHY_EDGE_SECOND_CHILD,
+        HIERARCHY_RANKS,
+        HIERARCHY_UPWARD_OFFSETS,
+        HIERARCHY_UPWARD_EDGES,
+        HIERARCHY_DOWNWARD_OFFSETS,
+        HIERARCHY_DOWNWARD_EDGES,
+        SECTION_COUNT,
+    };
+
+    constexpr size_t ELEMENT_SIZES[SECTION_COUNT] = {
+        sizeof(uint32_t), sizeof(uint32_t), sizeof(double), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(char),
+        sizeof(uint32_t), sizeof(uint32_t), sizeof(double), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t),
+        sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t) };
+
+    constexpr uint32_t NO_HIERARCHY_EDGE = graph::ContractionHierarchy<double>::NO_EDGE;
+
+    constexpr char MAGIC[8] = { 'T', 'C', 'R', 'O', 'U', 'T', 'E', '\0' };
+    constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    // FNV-1a   
+    class ChecksumBuilder {
+    public:
+        template <typename T>
+        void Add(const T& value) {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+            for (size_t i = 0; i < sizeof(T); ++i) {
+                hash_ = (hash_ ^ bytes[i]) * FNV_PRIME;
+            }
+        }
+
+        uint64_t Get() const {
+            return hash_;
+        }
+
+    private:
+        static constexpr uint64_t FNV_PRIME = 0x100000001b3ULL;
+        uint64_t hash_ = 0xcbf29ce484222325ULL;
+    };
+
+    uint64_t MixDistance(StopId from, StopId to, int meters) {
+        uint64_t key = ((static_cast<uint64_t>(from) << 32) | to) ^ (static_cast<uint64_t>(static_cast<uint32_t>(meters)) * 0x9e3779b97f4a7c15ULL);
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return key;
+    }
+
+    // и    vertex   ()   ()  
+    void CheckHierarchyGraph(ArrayView<uint32_t> offsets, ArrayView<uint32_t> edges, ArrayView<uint32_t> edge_vertices) {
+        CheckImage(offsets.front() == 0 && offsets.back() == edges.size(), "hierarchy offsets do not match edges");
+        for (size_t vertex = 0; vertex + 1 < offsets.size(); ++vertex) {
+            CheckImage(offsets[vertex] <= offsets[vertex + 1], "hierarchy offsets are not sorted");
+            for (uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; ++i) {
+                CheckImage(edges[i] < edge_vertices.size() && edge_vertices[edges[i]] == vertex,
+                    "hierarchy edge does not belong to its vertex");
+            }
+        }
+    }
+
+}  // namespace
+
+struct RoutingImage::Header {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t byte_order;
+    uint64_t file_size;
+    uint64_t checksum;
+    uint64_t vertex_count;
+    uint64_t edge_count;
+    uint64_t route_table_cell_size;
+    uint64_t hierarchy_edge_count;
+    ImageSection sections[SECTION_COUNT];
+};
+
+uint64_t ComputeRoutingChecksum(const TransportCatalogue& catalogue, const RoutingSettings& settings) {
+    ChecksumBuilder checksum;
+    checksum.Add(settings.bus_wait_time);
+    checksum.Add(settings.bus_velocity);
+    checksum.Add(static_cast<uint32_t>(settings.router_type));
+    checksum.Add(static_cast<uint32_t>(settings.router_compact_table));
+
+    checksum.Add(static_cast<uint64_t>(catalogue.GetAllStopsCount()));
+    const geo::CoordinateArrays& coordinates = catalogue.GetStopCoordinates();
+    for (size_t stop = 0; stop < coordinates.GetSize(); ++stop) {
+        checksum.Add(coordinates.GetLatitudes()[stop]);
+        checksum.Add(coordinates.GetLongitudes()[stop]);
+    }
+    checksum.Add(static_cast<uint64_t>(catalogue.GetAllBuses().size()));
+    for (const Bus& bus : catalogue.GetAllBuses()) {
+        checksum.Add(static_cast<uint64_t>(bus.stops.size()));
+        for (const StopId stop : bus.stops) {
+            checksum.Add(stop);
+        }
+    }
+    //        ,     
+    uint64_t distances = 0;
+    catalogue.ForEachDistance([&distances](StopId from, StopId to, int meters) {
+        distances += MixDistance(from, to, meters);
+        });
+    checksum.Add(distances);
+    return checksum.Get();
+}
+
+void WriteRoutingImage(const RoutingImageContent& content, std::ostream& output) {
+    const size_t edge_count = content.edge_from.size();
+    const uint64_t table_size = content.route_table == nullptr ? 0
+        : content.vertex_count * content.vertex_count * content.route_table_cell_size;
+
+    ImageLayout layout(sizeof(RoutingImage::Header));
+    layout.AddSection(content.edge_from);
+    layout.AddSection(content.edge_to);
+    layout.AddSection(content.edge_weight);
+    layout.AddSection(content.edge_owner);
+    layout.AddSection(content.edge_span_count);
+    layout.AddSection(content.edge_type);
+    layout.AddSection(content.route_table, table_size);
+    const HierarchyData& hierarchy = content.hierarchy;
+    layout.AddSection(hierarchy.edge_from);
+    layout.AddSection(hierarchy.edge_to);
+    layout.AddSection(hierarchy.edge_weight);
+    layout.AddSection(hierarchy.edge_original);
+    layout.AddSection(hierarchy.edge_first_child);
+    layout.AddSection(hierarchy.edge_second_child);
+    layout.AddSection(hierarchy.ranks);
+    layout.AddSection(hierarchy.upward_offsets);
+    layout.AddSection(hierarchy.upward_edges);
+    layout.AddSection(hierarchy.downward_offsets);
+    layout.AddSection(hierarchy.downward_edges);
+
+    RoutingImage::Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.format_version = RoutingImage::FORMAT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.file_size = layout.GetSize();
+    header.checksum = content.checksum;
+    header.vertex_count = content.vertex_count;
+    header.edge_count = edge_count;
+    header.route_table_cell_size = content.route_table == nullptr ? 0 : content.route_table_cell_size;
+    header.hierarchy_edge_count = hierarchy.edge_from.size();
+    std::copy(layout.GetSections().begin(), layout.GetSections().end(), header.sections);
+    layout.Write(output, &header);
+}
+
+std::shared_ptr<const RoutingImage> RoutingImage::Open(const std::string& path) {
+    std::shared_ptr<RoutingImage> image(new RoutingImage(path));
+    image->Validate();
+    return image;
+}
+
+RoutingImage::RoutingImage(const std::string& path)
+    : file_(path) {
+}
+
+const RoutingImage::Header& RoutingImage::GetHeader() const {
+    return *reinterpret_cast<const Header*>(file_.GetData());
+}
+
+template <typename T>
+ArrayView<T> RoutingImage::GetSection(size_t section) const {
+    return GetImageSection<T>(file_.GetData(), GetHeader().sections[section]);
+}
+
+void RoutingImage::Validate() const {
+    const size_t size = file_.GetSize();
+    CheckImage(size >= sizeof(Header), "file is too short");
+    const Header& header = GetHeader();
+    CheckImage(std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0, "wrong magic");
+    CheckImage(header.format_version == FORMAT_VERSION, "unsupported format version");
+    CheckImage(header.byte_order == BYTE_ORDER_MARK, "wrong byte order");
+    CheckImage(header.file_size == size, "file size mismatch");
+
+    for (size_t section = 0; section < SECTION_COUNT; ++section) {
+        CheckImageSection(header.sections[section], size, ELEMENT_SIZES[section]);
+        if (section < ROUTE_TABLE) {
+            CheckImage(header.sections[section].size / ELEMENT_SIZES[section] == header.edge_count,
+                "section length does not match edge count");
+        }
+    }
+    //  : vertex_count^2 * cell_size       
+    const uint64_t table_size = header.sections[ROUTE_TABLE].size;
+    if (header.route_table_cell_size == 0) {
+        CheckImage(table_size == 0, "route table without cell size");
+    }
+    else {
+        CheckImage(header.vertex_count == 0 || (header.vertex_count <= table_size / header.vertex_count
+            && table_size == header.vertex_count * header.vertex_count * header.route_table_cell_size),
+            "route table size does not match vertex count");
+    }
+
+    for (const uint32_t vertex : GetEdgeFrom()) {
+        CheckImage(vertex < header.vertex_count, "vertex is out of range");
+    }
+    for (const uint32_t vertex : GetEdgeTo()) {
+        CheckImage(vertex < header.vertex_count, "vertex is out of range");
+    }
+    for (const uint32_t type : GetSection<uint32_t>(EDGE_TYPE)) {
+        CheckImage(type <= static_cast<uint32_t>(EdgeType::WAIT), "unknown edge type");
+    }
+    ValidateHierarchy();
+}
+
+//         ,    ,
+//     :       
+void RoutingImage::ValidateHierarchy() const {
+    const Header& header = GetHeader();
+    if (!HasHierarchy()) {
+        CheckImage(header.hierarchy_edge_count == 0, "hierarchy edges without hierarchy");
+        for (size_t section = HIERARCHY_EDGE_FROM; section < SECTION_COUNT; ++section) {
+            CheckImage(header.sections[section].size == 0, "hierarchy section without hierarchy");
+        }
+        return;
+    }
+    const uint64_t edge_count = header.hierarchy_edge_count;
+    CheckImage(edge_count < NO_HIERARCHY_EDGE, "too many hierarchy edges");
+    for (size_t section = HIERARCHY_EDGE_FROM; section <= HIERARCHY_EDGE_SECOND_CHILD; ++section) {
+        CheckImage(header.sections[section].size / ELEMENT_SIZES[section] == edge_count,
+            "hierarchy section length does not match hierarchy edge count");
+    }
+    const HierarchyData hierarchy = GetHierarchy();
+    CheckImage(hierarchy.ranks.size() == header.vertex_count, "hierarchy ranks do not match vertex count");
+    CheckImage(hierarchy.upward_offsets.size() == header.vertex_count + 1
+        && hierarchy.downward_offsets.size() == header.vertex_count + 1, "hierarchy offsets do not match vertex count");
+
+    for (uint32_t edge = 0; edge < edge_count; ++edge) {
+        CheckImage(hierarchy.edge_from[edge] < header.vertex_count && hierarchy.edge_to[edge] < header.vertex_count,
+            "hierarchy vertex is out of range");
+        CheckImage(hierarchy.edge_weight[edge] >= 0.0, "hierarchy edge weight should be non-negative");
+        if (hierarchy.edge_original[edge] == NO_HIERARCHY_EDGE) {
+            CheckImage(hierarchy.edge_first_child[edge] < edge && hierarchy.edge_second_child[edge] < edge,
+                "shortcut child is out of range");
+        }
+        else {
+            CheckImage(hierarchy.edge_original[edge] < header.edge_count, "hierarchy original edge is out of range");
+        }
+    }
+    CheckHierarchyGraph(hierarchy.upward_offsets, hierarchy.upward_edges, hierarchy.edge_from);
+    CheckHierarchyGraph(hierarchy.downward_offsets, hierarchy.downward_edges, hierarchy.edge_to);
+}
+
+uint64_t RoutingImage::GetChecksum() const {
+    return GetHeader().checksum;
+}
+
+size_t RoutingImage::GetVertexCount() const {
+    return static_cast<size_t>(GetHeader().vertex_count);
+}
+
+size_t RoutingImage::GetEdgeCount() const {
+    return static_cast<size_t>(GetHeader().edge_count);
+}
+
+ArrayView<uint32_t> RoutingImage::GetEdgeFrom() const {
+    return GetSection<uint32_t>(EDGE_FROM);
+}
+
+ArrayView<uint32_t> RoutingImage::GetEdgeTo() const {
+    return GetSection<uint32_t>(EDGE_TO);
+}
+
+ArrayView<double> RoutingImage::GetEdgeWeight() const {
+    return GetSection<double>(EDGE_WEIGHT);
+}
+
+ArrayView<uint32_t> RoutingImage::GetEdgeOwner() const {
+    return GetSection<uint32_t>(EDGE_OWNER);
+}
+
+ArrayView<uint32_t> RoutingImage::GetEdgeSpanCount() const {
+    return GetSection<uint32_t>(EDGE_SPAN_COUNT);
+}
+
+EdgeType RoutingImage::GetEdgeType(size_t edge) const {
+    return static_cast<EdgeType>(GetSection<uint32_t>(EDGE_TYPE)[edge]);
+}
+
+const void* RoutingImage::GetRouteTable() const {
+    return GetHeader().route_table_cell_size == 0 ? nullptr : file_.GetData() + GetHeader().sections[ROUTE_TABLE].offset;
+}
+
+size_t RoutingImage::GetRouteTableCellSize() const {
+    return static_cast<size_t>(GetHeader().route_table_cell_size);
+}
+
+bool RoutingImage::HasHierarchy() const {
+    return GetHeader().sections[HIERARCHY_UPWARD_OFFSETS].size != 0;
+}
+
+HierarchyData RoutingImage::GetHierarchy() const {
+    return { GetSection<uint32_t>(HIERARCHY_EDGE_FROM), GetSection<uint32_t>(HIERARCHY_EDGE_TO),
+        GetSection<double>(HIERARCHY_EDGE_WEIGHT), GetSection<uint32_t>(HIERARCHY_EDGE_ORIGINAL),
+        GetSection<uint32_t>(HIERARCHY_EDGE_FIRST_CHILD), GetSection<uint32_t>(HIERARCHY_EDGE_SECOND_CHILD),
+        GetSection<uint32_t>(HIERARCHY_RANKS),
+        GetSection<uint32_t>(HIERARCHY_UPWARD_OFFSETS), GetSection<uint32_t>(HIERARCHY_UPWARD_EDGES),
+        GetSection<uint32_t>(HIERARCHY_DOWNWARD_OFFSETS), GetSection<uint32_t>(HIERARCHY_DOWNWARD_EDGES) };
+}
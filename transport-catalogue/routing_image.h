@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "contraction_hierarchy.h"
+#include "domain.h"
+#include "mapped_file.h"
+
+class TransportCatalogue;
+
+using HierarchyData = graph::ContractionHierarchy<double>::HierarchyData;
+
+//      ,     :
+//  , ,      
+uint64_t ComputeRoutingChecksum(const TransportCatalogue& catalogue, const RoutingSettings& settings);
+
+//     
+struct RoutingImageContent {
+    uint64_t checksum = 0;
+    uint64_t vertex_count = 0;
+    std::vector<uint32_t> edge_from;
+    std::vector<uint32_t> edge_to;
+    std::vector<double> edge_weight;
+    std::vector<uint32_t> edge_owner;
+    std::vector<uint32_t> edge_span_count;
+    std::vector<uint32_t> edge_type;
+    //     ALL_PAIRS,  
+    const void* route_table = nullptr;
+    uint64_t route_table_cell_size = 0;
+    //    CONTRACTION_HIERARCHY,  
+    HierarchyData hierarchy;
+};
+
+void WriteRoutingImage(const RoutingImageContent& content, std::ostream& output);
+
+//    :     EdgeId,  ,
+//      .       
+//    
+class RoutingImage {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 3;
+
+    //  std::runtime_error,          
+    static std::shared_ptr<const RoutingImage> Open(const std::string& path);
+
+    uint64_t GetChecksum() const;
+    size_t GetVertexCount() const;
+    size_t GetEdgeCount() const;
+
+    ArrayView<uint32_t> GetEdgeFrom() const;
+    ArrayView<uint32_t> GetEdgeTo() const;
+    ArrayView<double> GetEdgeWeight() const;
+    ArrayView<uint32_t> GetEdgeOwner() const;
+    ArrayView<uint32_t> GetEdgeSpanCount() const;
+    EdgeType GetEdgeType(size_t edge) const;
+
+    // nullptr,   
+    const void* GetRouteTable() const;
+    size_t GetRouteTableCellSize() const;
+
+    bool HasHierarchy() const;
+    //     : ,   CSR   
+    HierarchyData GetHierarchy() const;
+
+private:
+    struct Header;
+    friend void WriteRoutingImage(const RoutingImageContent& content, std::ostream& output);
+
+    explicit RoutingImage(const std::string& path);
+    void Validate() const;
+    void ValidateHierarchy() const;
+    const Header& GetHeader() const;
+    template <typename T>
+    ArrayView<T> GetSection(size_t section) const;
+
+    MappedFile file_;
+};
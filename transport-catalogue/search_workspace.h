@@ -0,0 +1,67 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace graph {
+
+    //     .    - O(1)    
+    template <typename Weight>
+    class SearchWorkspace {
+    public:
+        void Reset(size_t vertex_count) {
+            if (stamps_.size() < vertex_count) {
+                weights_.resize(vertex_count);
+                prev_edges_.resize(vertex_count);
+                stamps_.resize(vertex_count, 0);
+            }
+            if (++stamp_ == 0) {
+                std::fill(stamps_.begin(), stamps_.end(), 0);
+                stamp_ = 1;
+            }
+        }
+
+        bool IsReached(VertexId vertex) const {
+            return stamps_[vertex] == stamp_;
+        }
+
+        std::optional<Weight> FindWeight(VertexId vertex) const {
+            return IsReached(vertex) ? std::optional<Weight>(weights_[vertex]) : std::nullopt;
+        }
+
+        Weight GetWeight(VertexId vertex) const {
+            return weights_[vertex];
+        }
+
+        EdgeId GetPrevEdge(VertexId vertex) const {
+            return prev_edges_[vertex];
+        }
+
+        void Reach(VertexId vertex, Weight weight, EdgeId prev_edge) {
+            weights_[vertex] = weight;
+            prev_edges_[vertex] = prev_edge;
+            stamps_[vertex] = stamp_;
+        }
+
+    private:
+        std::vector<Weight> weights_;
+        std::vector<EdgeId> prev_edges_;
+        std::vector<uint32_t> stamps_;
+        uint32_t stamp_ = 0;
+    };
+
+    //     ; slot  ,     
+    template <typename Weight>
+    SearchWorkspace<Weight>& GetThreadWorkspace(size_t slot, size_t vertex_count) {
+        static thread_local std::array<SearchWorkspace<Weight>, 2> workspaces;
+        SearchWorkspace<Weight>& workspace = workspaces.at(slot);
+        workspace.Reset(vertex_count);
+        return workspace;
+    }
+
+}  // namespace graph
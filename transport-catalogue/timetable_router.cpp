@@ -0,0 +1,107 @@
+#include "timetable_router.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace transport_router {
+
+	namespace {
+		constexpr double UNREACHED = std::numeric_limits<double>::infinity();
+		constexpr uint32_t NO_CONNECTION = std::numeric_limits<uint32_t>::max();
+	}
+
+	TimetableRouter::TimetableRouter(const TransportCatalogue& db, double velocity_factor)
+		: stop_count_(db.GetAllStopsCount()) {
+
+		for (const Bus& bus : db.GetAllBuses()) {
+			if (bus.departures.empty() || bus.stops.size() < 2) {
+				continue;
+			}
+			const ArrayView<double> distances = db.GetBusPrefixDistances(bus.id);
+			std::vector<double> ride_times(bus.stops.size(), 0.0);
+			for (size_t position = 1; position < bus.stops.size(); ++position) {
+				ride_times[position] = ride_times[position - 1]
+					+ (distances[position] - distances[position - 1]) / velocity_factor;
+			}
+			for (const double departure : bus.departures) {
+				const uint32_t trip = static_cast<uint32_t>(trips_.size());
+				trips_.push_back({ &bus });
+				for (size_t position = 0; position + 1 < bus.stops.size(); ++position) {
+					connections_.push_back({ departure + ride_times[position], departure + ride_times[position + 1],
+						bus.stops[position], bus.stops[position + 1],
+						trip, static_cast<uint32_t>(position) });
+				}
+			}
+		}
+
+		//          :   
+		//       .    
+		std::stable_sort(connections_.begin(), connections_.end(), [](const Connection& lhs, const Connection& rhs) {
+			return lhs.departure < rhs.departure || (lhs.departure == rhs.departure && lhs.arrival < rhs.arrival);
+			});
+		if (connections_.size() >= NO_CONNECTION) {
+			throw std::length_error("Too many connections");
+		}
+	}
+
+	std::optional<TimetableRouter::Journey> TimetableRouter::BuildRoute(StopId from, StopId to,
+		double departure_time) const {
+		const uint32_t stop_from = from;
+		const uint32_t stop_to = to;
+		if (stop_from >= stop_count_ || stop_to >= stop_count_) {
+			throw std::out_of_range("Stop is out of range");
+		}
+
+		std::vector<double> arrivals(stop_count_, UNREACHED);
+		std::vector<Label> labels(stop_count_, { NO_CONNECTION, NO_CONNECTION });
+		std::vector<uint32_t> trip_boardings(trips_.size(), NO_CONNECTION);
+		arrivals[stop_from] = departure_time;
+
+		auto first = std::lower_bound(connections_.begin(), connections_.end(), departure_time,
+			[](const Connection& connection, double time) { return connection.departure < time; });
+		for (auto it = first; it != connections_.end(); ++it) {
+			const Connection& connection = *it;
+			if (arrivals[stop_to] <= connection.departure) {
+				break;
+			}
+			const uint32_t index = static_cast<uint32_t>(it - connections_.begin());
+			if (trip_boardings[connection.trip] == NO_CONNECTION) {
+				if (arrivals[connection.stop_from] > connection.departure) {
+					continue;
+				}
+				trip_boardings[connection.trip] = index;
+			}
+			if (connection.arrival < arrivals[connection.stop_to]) {
+				arrivals[connection.stop_to] = connection.arrival;
+				labels[connection.stop_to] = { trip_boardings[connection.trip], index };
+			}
+		}
+
+		if (arrivals[stop_to] == UNREACHED) {
+			return std::nullopt;
+		}
+
+		std::vector<Label> legs;
+		for (uint32_t stop = stop_to; stop != stop_from; stop = connections_[legs.back().board_connection].stop_from) {
+			if (legs.size() > stop_count_) {
+				throw std::logic_error("Journey reconstruction failed");
+			}
+			legs.push_back(labels[stop]);
+		}
+		std::reverse(legs.begin(), legs.end());
+
+		Journey journey;
+		journey.total_time = arrivals[stop_to] - departure_time;
+		double time = departure_time;
+		for (const Label& leg : legs) {
+			const Connection& board = connections_[leg.board_connection];
+			const Connection& alight = connections_[leg.alight_connection];
+			journey.rides.push_back({ trips_[board.trip].bus, board.position, alight.position + 1,
+				board.departure - time, alight.arrival - board.departure });
+			time = alight.arrival;
+		}
+		return journey;
+	}
+
+} // namespace transport_router
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "raptor_router.h"
+#include "transport_catalogue.h"
+
+namespace transport_router {
+
+	// Earliest arrival   (Connection Scan Algorithm)
+	class TimetableRouter {
+	public:
+		using Ride = RaptorRouter::Ride;
+		using Journey = RaptorRouter::Journey;
+
+		TimetableRouter(const TransportCatalogue& db, double velocity_factor);
+
+		std::optional<Journey> BuildRoute(StopId from, StopId to, double departure_time) const;
+
+	private:
+		struct Connection {
+			double departure;
+			double arrival;
+			uint32_t stop_from;
+			uint32_t stop_to;
+			uint32_t trip;
+			uint32_t position;
+		};
+
+		struct Trip {
+			const Bus* bus;
+		};
+
+		struct Label {
+			uint32_t board_connection;
+			uint32_t alight_connection;
+		};
+
+		std::vector<Connection> connections_;
+		std::vector<Trip> trips_;
+		size_t stop_count_;
+	};
+
+} // namespace transport_router
@@ -1,81 +1,305 @@
 
 #include "transport_catalogue.h"
 
+#include "catalogue_image.h"
+
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+
+namespace {
+    //        
+    constexpr size_t MIN_BUSES_PER_THREAD = 256;
+}
+
 const Stop* TransportCatalogue::FindStop(std::string_view stop_name) const {
-    if (stopname_to_stop_.count(stop_name)) {
-        return stopname_to_stop_.at(stop_name);
+    if (image_ != nullptr) {
+        const std::optional<StopId> id = image_->FindStop(stop_name);
+        return id ? &stops_[*id] : nullptr;
     }
-    return nullptr;
+    const auto it = stopname_to_stop_.find(stop_name);
+    return it == stopname_to_stop_.end() ? nullptr : &stops_[it->second];
+}
+
+const Stop& TransportCatalogue::GetStop(StopId id) const {
+    return stops_.at(id);
 }
 
 void TransportCatalogue::AddStop(std::string stop, geo::Coordinates coordinates) {
+    CheckMutable();
     if (!stopname_to_stop_.count(stop)) {
-        stops_.push_back({ std::move(stop), coordinates });
-        stopname_to_stop_.insert({ stops_.back().stop_name, &stops_.back() });
-        stops_to_buses_.insert({ &stops_.back(), {} });
+        owned_names_.push_back(std::move(stop));
+        stops_.push_back({ owned_names_.back(), coordinates, static_cast<StopId>(stops_.size()) });
+        stop_coordinates_.Add(coordinates);
+        stopname_to_stop_.insert({ stops_.back().stop_name, stops_.back().id });
+        finalized_ = false;
     }
 }
 
 void TransportCatalogue::SetDistanceBetweenStops(std::string_view from_stop, std::string_view to_stop, Distance distance) {
+    CheckMutable();
     auto current_stop = FindStop(from_stop);
     auto stop_to = FindStop(to_stop);
+    if (current_stop == nullptr) {
+        throw std::invalid_argument("Unknown stop " + std::string(from_stop));
+    }
     if (stop_to != nullptr) {
-        StopPair pair_stops = {current_stop, stop_to};
-        distances_.insert({pair_stops, distance});      
+        distances_.Insert(current_stop->id, stop_to->id, distance.meters);
+        finalized_ = false;
     }
 }
 
 const Bus* TransportCatalogue::FindBus(std::string_view bus) const {
-    if (busname_to_bus_.count(bus)) {
-        return busname_to_bus_.at(bus);
+    if (image_ != nullptr) {
+        const std::optional<BusId> id = image_->FindBus(bus);
+        return id ? &buses_[*id] : nullptr;
     }
-    return nullptr;
+    const auto it = busname_to_bus_.find(bus);
+    return it == busname_to_bus_.end() ? nullptr : &buses_[it->second];
+}
+
+const Bus& TransportCatalogue::GetBus(BusId id) const {
+    return buses_.at(id);
 }
 
 void TransportCatalogue::AddBus(std::string bus_name, const std::vector<std::string>& stops, TypeRoute type) {
-    Bus bus(bus_name);
+    CheckMutable();
     if (!busname_to_bus_.count(bus_name)) {
+        std::vector<StopId> bus_stops;
+        bus_stops.reserve(stops.size());
         for (auto& stop : stops) {
-            bus.stops.emplace_back(const_cast<Stop*>(FindStop(stop)));
+            const Stop* found = FindStop(stop);
+            if (found == nullptr) {
+                throw std::invalid_argument("Unknown stop " + stop);
+            }
+            bus_stops.emplace_back(found->id);
         }
+        owned_names_.push_back(std::move(bus_name));
+        owned_bus_stops_.push_back(std::move(bus_stops));
+        Bus bus(owned_names_.back());
+        bus.stops = owned_bus_stops_.back();
         bus.is_roundtrip = (std::move(type));
-        buses_.push_back(std::move(bus));
-        std::string_view bus_ptr_name = buses_.back().bus_name;
-        busname_to_bus_.insert({ bus_ptr_name, &buses_.back() });
-        for (auto& stop_ptr : buses_.back().stops) {
-            std::string_view bus_ptr_name = buses_.back().bus_name;
-            if (stops_to_buses_.count(stop_ptr)) {
-                stops_to_buses_.at(stop_ptr).insert(busname_to_bus_.at(bus_ptr_name));
-            }
+        bus.id = static_cast<BusId>(buses_.size());
+        buses_.push_back(bus);
+        busname_to_bus_.insert({ buses_.back().bus_name, buses_.back().id });
+        finalized_ = false;
+    }
+}
+
+void TransportCatalogue::SetBusDepartures(std::string_view bus_name, std::vector<double> departures) {
+    CheckMutable();
+    if (busname_to_bus_.count(bus_name)) {
+        Bus& bus = buses_[busname_to_bus_.at(bus_name)];
+        std::sort(departures.begin(), departures.end());
+        if (owned_departures_.size() <= bus.id) {
+            owned_departures_.resize(bus.id + 1);
         }
+        owned_departures_[bus.id] = std::move(departures);
+        bus.departures = owned_departures_[bus.id];
     }
 }
 
 Distance TransportCatalogue::GetDistance(const Stop* from, const Stop* to) const {
-    StopPair key  = {from , to};
-    StopPair rkey = {to , from};
-    if (distances_.count(key))  return distances_.at(key);
-    if (distances_.count(rkey)) return distances_.at(rkey);
+    return GetDistance(from->id, to->id);
+}
+
+Distance TransportCatalogue::GetDistance(StopId from, StopId to) const {
+    if (auto meters = distances_.Find(from, to)) return Distance{ *meters };
+    if (auto meters = distances_.Find(to, from)) return Distance{ *meters };
     return Distance{ 0 };
 }
 
-const std::unordered_set<Bus*>* TransportCatalogue::FindBusesForStop(const std::string_view stop) const {
-    auto stop_ptr = const_cast<Stop*>(FindStop(stop));
-    if (stops_to_buses_.count(stop_ptr)) {
-        return &stops_to_buses_.at(stop_ptr);
+const std::vector<Bus>& TransportCatalogue::GetAllBuses() const {
+    return buses_; 
+}
+
+size_t TransportCatalogue::GetAllStopsCount() const {
+    return stops_.size();
+}
+
+const geo::CoordinateArrays& TransportCatalogue::GetStopCoordinates() const {
+    return stop_coordinates_;
+}
+
+const DistanceIndex& TransportCatalogue::GetDistanceIndex() const {
+    return distances_;
+}
+
+void TransportCatalogue::Finalize(size_t thread_count) {
+    FinalizeBusStats(thread_count);
+    ComputeStopBuses();
+    finalized_ = true;
+}
+
+void TransportCatalogue::LoadImage(const CatalogueImage& image) {
+    if (!stops_.empty() || !buses_.empty()) {
+        throw std::logic_error("TransportCatalogue::LoadImage() expects an empty catalogue");
     }
-    return nullptr;
+    image_ = &image;
+
+    stops_.reserve(image.GetStopCount());
+    stop_coordinates_.Reserve(image.GetStopCount());
+    size_t stop_bus_count = 0;
+    for (StopId id = 0; id < image.GetStopCount(); ++id) {
+        stops_.push_back({ image.GetStopName(id), image.GetStopCoordinates(id), id });
+        stop_coordinates_.Add(stops_.back().coordinates);
+        stop_bus_count += image.GetStopBuses(id).size();
+    }
+
+    distances_.Attach(image.GetDistanceSlotKeys(), image.GetDistanceSlotMeters(), image.GetDistanceCount());
+
+    buses_.reserve(image.GetBusCount());
+    bus_stats_.reserve(image.GetBusCount());
+    bus_prefix_distances_.reserve(image.GetBusCount());
+    for (BusId id = 0; id < image.GetBusCount(); ++id) {
+        Bus bus(image.GetBusName(id));
+        bus.stops = image.GetBusStops(id);
+        bus.is_roundtrip = image.GetBusRouteType(id);
+        bus.id = id;
+        bus.departures = image.GetBusDepartures(id);
+        buses_.push_back(bus);
+        bus_stats_.push_back(image.GetBusStat(id));
+        bus_prefix_distances_.push_back(image.GetBusPrefixDistances(id));
+    }
+
+    stop_bus_names_.reserve(stop_bus_count);
+    stop_bus_offsets_.reserve(stops_.size() + 1);
+    stop_bus_offsets_.assign(1, 0);
+    for (StopId id = 0; id < stops_.size(); ++id) {
+        for (const BusId bus : image.GetStopBuses(id)) {
+            stop_bus_names_.push_back(buses_[bus].bus_name);
+        }
+        stop_bus_offsets_.push_back(static_cast<uint32_t>(stop_bus_names_.size()));
+    }
+    finalized_ = true;
 }
 
-const std::deque<Bus>& TransportCatalogue::GetAllBuses() const {
-    return buses_; 
+void TransportCatalogue::CheckMutable() const {
+    if (image_ != nullptr) {
+        throw std::logic_error("Catalogue loaded from an image can not be changed");
+    }
 }
 
-const TransportCatalogue::Stops& TransportCatalogue::GetAllStops() const {
-    return stopname_to_stop_;
+void TransportCatalogue::FinalizeBusStats(size_t thread_count) {
+    bus_stats_.assign(buses_.size(), BusStat{});
+    //         
+    std::vector<size_t> prefix_offsets(buses_.size() + 1, 0);
+    for (size_t bus_index = 0; bus_index < buses_.size(); ++bus_index) {
+        prefix_offsets[bus_index + 1] = prefix_offsets[bus_index] + buses_[bus_index].stops.size();
+    }
+    owned_prefix_distances_.assign(prefix_offsets.back(), 0.0);
+    bus_prefix_distances_.clear();
+    bus_prefix_distances_.reserve(buses_.size());
+    for (size_t bus_index = 0; bus_index < buses_.size(); ++bus_index) {
+        bus_prefix_distances_.emplace_back(owned_prefix_distances_.data() + prefix_offsets[bus_index],
+            owned_prefix_distances_.data() + prefix_offsets[bus_index + 1]);
+    }
+
+    if (thread_count == 0) {
+        thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    thread_count = std::max<size_t>(std::min(thread_count, buses_.size() / MIN_BUSES_PER_THREAD), 1);
+
+    if (thread_count == 1) {
+        ComputeBusStats(0, buses_.size(), prefix_offsets);
+    }
+    else {
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count);
+        const size_t chunk = (buses_.size() + thread_count - 1) / thread_count;
+        for (size_t begin = 0; begin < buses_.size(); begin += chunk) {
+            threads.emplace_back([this, begin, chunk, &prefix_offsets] {
+                ComputeBusStats(begin, std::min(begin + chunk, buses_.size()), prefix_offsets);
+                });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
 }
 
-size_t TransportCatalogue::GetAllStopsCount() const {
-    return stops_.size();
+const BusStat& TransportCatalogue::GetBusStat(BusId id) const {
+    if (!finalized_) {
+        throw std::logic_error("TransportCatalogue::Finalize() should be called before bus stat queries");
+    }
+    return bus_stats_.at(id);
+}
+
+ArrayView<double> TransportCatalogue::GetBusPrefixDistances(BusId id) const {
+    if (!finalized_) {
+        throw std::logic_error("TransportCatalogue::Finalize() should be called before bus distance queries");
+    }
+    return bus_prefix_distances_.at(id);
+}
+
+ArrayView<std::string_view> TransportCatalogue::GetStopBuses(StopId id) const {
+    if (!finalized_) {
+        throw std::logic_error("TransportCatalogue::Finalize() should be called before stop buses queries");
+    }
+    const std::string_view* names = stop_bus_names_.data();
+    return { names + stop_bus_offsets_.at(id), names + stop_bus_offsets_.at(id + 1) };
+}
+
+void TransportCatalogue::ComputeBusStats(size_t bus_begin, size_t bus_end, const std::vector<size_t>& prefix_offsets) {
+    //     ,      
+    std::vector<size_t> last_seen(stops_.size(), buses_.size());
+    for (size_t bus_index = bus_begin; bus_index < bus_end; ++bus_index) {
+        const Bus& bus = buses_[bus_index];
+        double* prefix = owned_prefix_distances_.data() + prefix_offsets[bus_index];
+        size_t unique_stops = 0;
+        double length(0.0);
+        for (size_t i = 0; i < bus.stops.size(); ++i) {
+            if (last_seen[bus.stops[i]] != bus_index) {
+                last_seen[bus.stops[i]] = bus_index;
+                ++unique_stops;
+            }
+            if (i > 0) {
+                length += GetDistance(bus.stops[i - 1], bus.stops[i]).meters;
+            }
+            prefix[i] = length;
+        }
+        bus_stats_[bus_index] = { bus.stops.size(), unique_stops, length,
+            geo::ComputeCurvature(stop_coordinates_, bus.stops, length) };
+    }
+}
+
+void TransportCatalogue::ComputeStopBuses() {
+    std::vector<const Bus*> sorted_buses;
+    sorted_buses.reserve(buses_.size());
+    for (const Bus& bus : buses_) {
+        sorted_buses.push_back(&bus);
+    }
+    std::sort(sorted_buses.begin(), sorted_buses.end(), [](const Bus* lhs, const Bus* rhs) {
+        return lhs->bus_name < rhs->bus_name;
+        });
+
+    //      ,     .
+    //     ,     
+    std::vector<size_t> last_seen(stops_.size(), buses_.size());
+    stop_bus_offsets_.assign(stops_.size() + 1, 0);
+    for (const Bus* bus : sorted_buses) {
+        for (StopId stop : bus->stops) {
+            if (last_seen[stop] != bus->id) {
+                last_seen[stop] = bus->id;
+                ++stop_bus_offsets_[stop + 1];
+            }
+        }
+    }
+    for (size_t stop = 0; stop < stops_.size(); ++stop) {
+        stop_bus_offsets_[stop + 1] += stop_bus_offsets_[stop];
+    }
+
+    stop_bus_names_.resize(stop_bus_offsets_.back());
+    std::vector<uint32_t> positions(stop_bus_offsets_.begin(), stop_bus_offsets_.end() - 1);
+    std::fill(last_seen.begin(), last_seen.end(), buses_.size());
+    for (const Bus* bus : sorted_buses) {
+        for (StopId stop : bus->stops) {
+            if (last_seen[stop] != bus->id) {
+                last_seen[stop] = bus->id;
+                stop_bus_names_[positions[stop]++] = bus->bus_name;
+            }
+        }
+    }
 }
 
@@ -3,37 +3,88 @@
 #include <deque>
 #include <iostream>
 #include <set>
+#include <string>
 #include <string_view>
+#include <vector>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "distance_index.h"
 #include "domain.h"
-  
+
+class CatalogueImage;
+
+//      ,      
 class TransportCatalogue {
 
-using Stops = typename std::unordered_map<std::string_view, Stop*>;
-using Buses = typename std::unordered_map<std::string_view, Bus*>;
-using StopsToBuses = typename std::unordered_map<Stop*, std::unordered_set<Bus*>>;
-using StopPair = std::pair<const Stop*, const Stop*>;
-using Distances = std::unordered_map<StopPair, const Distance, StopPairHasher>;
+using StopIds = typename std::unordered_map<std::string_view, StopId>;
+using BusIds = typename std::unordered_map<std::string_view, BusId>;
     
 public:
     const Stop* FindStop(std::string_view stop_name) const;   
+    const Stop& GetStop(StopId id) const;
     void AddStop(std::string stop, geo::Coordinates coordinates);
+    // SetDistanceBetweenStops  AddBus  std::invalid_argument   .
+    // ,   ,  : AddStop, AddBus    std::logic_error
     void SetDistanceBetweenStops(std::string_view from_stop, std::string_view to_stop, Distance distance);
     const Bus* FindBus(std::string_view bus) const;
+    const Bus& GetBus(BusId id) const;
     void AddBus(std::string bus_name, const std::vector<std::string>& stops, TypeRoute type);
+    void SetBusDepartures(std::string_view bus_name, std::vector<double> departures);
     Distance GetDistance(const Stop* from, const Stop* to) const;
-    const std::unordered_set<Bus*>* FindBusesForStop(const std::string_view stop) const;
-    const std::deque<Bus>& GetAllBuses() const;
-    const Stops& GetAllStops() const;
+    Distance GetDistance(StopId from, StopId to) const;
+    const std::vector<Bus>& GetAllBuses() const;
     size_t GetAllStopsCount() const;
+    const geo::CoordinateArrays& GetStopCoordinates() const;
+    //        
+    const DistanceIndex& GetDistanceIndex() const;
+
+    // func(from, to, meters)    
+    template <typename Func>
+    void ForEachDistance(Func func) const {
+        distances_.ForEach(func);
+    }
+
+    //    ;    ,   .
+    // thread_count == 0 -   
+    void Finalize(size_t thread_count = 0);
+    //          . , 
+    // , ,         ,
+    //       ,   .    
+    //     ,   .     
+    void LoadImage(const CatalogueImage& image);
+    const BusStat& GetBusStat(BusId id) const;
+    // prefix[i] -        i-
+    ArrayView<double> GetBusPrefixDistances(BusId id) const;
+    //      ,  
+    ArrayView<std::string_view> GetStopBuses(StopId id) const;
     
 private:
-    std::deque<Stop> stops_;
-    std::deque<Bus> buses_;
-    Stops stopname_to_stop_;
-    Buses busname_to_bus_;
-    StopsToBuses stops_to_buses_;
-    Distances distances_;
+    void FinalizeBusStats(size_t thread_count);
+    void ComputeBusStats(size_t bus_begin, size_t bus_end, const std::vector<size_t>& prefix_offsets);
+    void ComputeStopBuses();
+    void CheckMutable() const;
+
+    std::vector<Stop> stops_;
+    geo::CoordinateArrays stop_coordinates_;
+    std::vector<Bus> buses_;
+    //    ,   AddStop  AddBus
+    StopIds stopname_to_stop_;
+    BusIds busname_to_bus_;
+    const CatalogueImage* image_ = nullptr;  //      LoadImage
+    DistanceIndex distances_;
+    std::vector<BusStat> bus_stats_;
+    std::vector<ArrayView<double>> bus_prefix_distances_;
+    //   id - stop_bus_names_[stop_bus_offsets_[id], stop_bus_offsets_[id + 1])
+    std::vector<std::string_view> stop_bus_names_;
+    std::vector<uint32_t> stop_bus_offsets_;
+    bool finalized_ = false;
+
+    //  ,   AddStop  AddBus;       .
+    //  deque  ,    Stop  Bus  
+    //   stops_  buses_
+    std::deque<std::string> owned_names_;
+    std::deque<std::vector<StopId>> owned_bus_stops_;
+    std::deque<std::vector<double>> owned_departures_;  //   
+    std::vector<double> owned_prefix_distances_;
 };
@@ -1,5 +1,8 @@
 #include "transport_router.h"
 
+#include <algorithm>
+#include <tuple>
+
 namespace transport_router {
 
 	TransportRouter::TransportRouter(const TransportCatalogue& db)
@@ -10,87 +13,338 @@ namespace transport_router {
 		settings_ = settings;
 	}
 
-	RoutingSettings TransportRouter::GetRoutingSettings() {
+	RoutingSettings TransportRouter::GetRoutingSettings() const {
 		return settings_;
 	}
 
-	RouteData TransportRouter::CalculateRoute(std::string_view from, std::string_view to) {
-		if (!router_) {
-			BuildGraph();
+	void TransportRouter::SetRoutingImage(std::shared_ptr<const RoutingImage> image) {
+		if (built_.load(std::memory_order_acquire)) {
+			throw std::logic_error("Routing image should be set before TransportRouter::Build()");
+		}
+		if (image->GetChecksum() != ComputeRoutingChecksum(tc_, settings_)) {
+			throw std::runtime_error("Routing image was built for another catalogue or routing settings");
+		}
+		routing_image_ = std::move(image);
+	}
+
+	void TransportRouter::WriteRoutingImage(std::ostream& output) const {
+		CheckBuilt();
+		RoutingImageContent content;
+		content.checksum = ComputeRoutingChecksum(tc_, settings_);
+		if (settings_.router_type != RouterType::RAPTOR) {
+			content.vertex_count = graph_.GetVertexCount();
+			const size_t edge_count = graph_.GetEdgeCount();
+			content.edge_from.reserve(edge_count);
+			content.edge_to.reserve(edge_count);
+			content.edge_weight.reserve(edge_count);
+			for (graph::EdgeId edge_id = 0; edge_id < edge_count; ++edge_id) {
+				const auto& edge = graph_.GetEdge(edge_id);
+				content.edge_from.push_back(static_cast<uint32_t>(edge.from));
+				content.edge_to.push_back(static_cast<uint32_t>(edge.to));
+				content.edge_weight.push_back(edge.weight);
+				content.edge_owner.push_back(edges_info_[edge_id].owner);
+				content.edge_span_count.push_back(edges_info_[edge_id].span_count);
+				content.edge_type.push_back(static_cast<uint32_t>(edges_info_[edge_id].type));
+			}
+		}
+		if (const auto* table_router = dynamic_cast<const graph::Router<double>*>(router_.get())) {
+			content.route_table = table_router->GetTable();
+			content.route_table_cell_size = sizeof(graph::Router<double>::RouteInternalData);
+		}
+		else if (const auto* compact_router = dynamic_cast<const graph::Router<double, float, uint32_t>*>(router_.get())) {
+			content.route_table = compact_router->GetTable();
+			content.route_table_cell_size = sizeof(graph::Router<double, float, uint32_t>::RouteInternalData);
+		}
+		else if (const auto* hierarchy = dynamic_cast<const graph::ContractionHierarchy<double>*>(router_.get())) {
+			content.hierarchy = hierarchy->GetData();
+		}
+		::WriteRoutingImage(content, output);
+	}
+
+	void TransportRouter::Build() {
+		std::call_once(build_flag_, [this] {
+			if (settings_.router_type == RouterType::RAPTOR) {
+				BuildRaptorRouter();
+			}
+			else {
+				if (routing_image_) {
+					LoadGraph();
+				}
+				else {
+					BuildGraph();
+				}
+				graph_.Freeze();
+				BuildRouter();
+				reachability_router_ = std::make_unique<graph::DijkstraRouter<double>>(graph_);
+			}
+			const double velocity_factor = settings_.bus_velocity * METERS_PER_KM / MIN_PER_HOUR;
+			timetable_router_ = std::make_unique<TimetableRouter>(tc_, velocity_factor);
+			built_.store(true, std::memory_order_release);
+			});
+	}
+
+	void TransportRouter::CheckBuilt() const {
+		if (!built_.load(std::memory_order_acquire)) {
+			throw std::logic_error("TransportRouter::Build() should be called before queries");
+		}
+	}
+
+	RouteData TransportRouter::CalculateRoute(std::string_view from, std::string_view to) const {
+		CheckBuilt();
+		if (settings_.router_type == RouterType::RAPTOR) {
+			return CalculateRaptorRoute(from, to);
 		}
 
 		RouteData result;
-		auto calculated_route = router_->BuildRoute(vertexes_.at(from).wait, vertexes_.at(to).wait);
+		auto calculated_route = router_->BuildRoute(GetWaitVertex(GetStopId(from)), GetWaitVertex(GetStopId(to)));
 
 		if (calculated_route) {
 			result.founded = true;
+			result.items.reserve(calculated_route->edges.size());
 			for (const auto& element_id : calculated_route->edges) {
-				auto edge_details = graph_.GetEdge(element_id);
-				result.total_time += edge_details.weight;
+				const double weight = graph_.GetEdge(element_id).weight;
+				const EdgeInfo& edge_info = edges_info_[element_id];
+				result.total_time += weight;
 				result.items.emplace_back(RouteItem{
-					edges_info_.at(element_id).edge_name,
-					edges_info_.at(element_id).type == EdgeType::TRAVEL ? edges_info_.at(element_id).span_count : 0,
-					edge_details.weight,
-					edges_info_.at(element_id).type });
+					edge_info.type == EdgeType::TRAVEL
+						? std::string_view(tc_.GetBus(edge_info.owner).bus_name)
+						: std::string_view(tc_.GetStop(edge_info.owner).stop_name),
+					static_cast<int>(edge_info.span_count),
+					weight,
+					edge_info.type });
 			}
 		}
 		return result;
 	}
 
+	RouteMatrix TransportRouter::CalculateRouteMatrix(const std::vector<std::string_view>& from,
+		const std::vector<std::string_view>& to) const {
+		CheckBuilt();
+		RouteMatrix result{ from.size(), to.size(), {} };
+		result.times.reserve(from.size() * to.size());
+
+		if (settings_.router_type == RouterType::RAPTOR) {
+			std::vector<StopId> targets;
+			targets.reserve(to.size());
+			for (const std::string_view stopname : to) {
+				targets.push_back(GetStopId(stopname));
+			}
+			for (const std::string_view stopname : from) {
+				const auto times = raptor_router_->BuildTimes(GetStopId(stopname), targets);
+				result.times.insert(result.times.end(), times.begin(), times.end());
+			}
+			return result;
+		}
+
+		std::vector<graph::VertexId> targets;
+		targets.reserve(to.size());
+		for (const std::string_view stopname : to) {
+			targets.push_back(GetWaitVertex(GetStopId(stopname)));
+		}
+		for (const std::string_view stopname : from) {
+			const auto times = router_->BuildWeights(GetWaitVertex(GetStopId(stopname)), targets);
+			result.times.insert(result.times.end(), times.begin(), times.end());
+		}
+		return result;
+	}
+
+	std::vector<ReachableStop> TransportRouter::CalculateReachable(std::string_view from, double max_time) const {
+		CheckBuilt();
+		std::vector<ReachableStop> result;
+
+		if (settings_.router_type == RouterType::RAPTOR) {
+			for (const auto& [stop, time] : raptor_router_->BuildReachable(GetStopId(from), max_time)) {
+				result.push_back({ tc_.GetStop(stop).stop_name, time });
+			}
+		}
+		else {
+			for (const auto& [vertex, time] : reachability_router_->BuildReachable(GetWaitVertex(GetStopId(from)), max_time)) {
+				//    
+				if (vertex % 2 == 0) {
+					result.push_back({ tc_.GetStop(static_cast<StopId>(vertex / 2)).stop_name, time });
+				}
+			}
+		}
+
+		std::sort(result.begin(), result.end(), [](const ReachableStop& lhs, const ReachableStop& rhs) {
+			return std::tie(lhs.time, lhs.stop_name) < std::tie(rhs.time, rhs.stop_name);
+			});
+		return result;
+	}
+
+	RouteData TransportRouter::CalculateRaptorRoute(std::string_view from, std::string_view to) const {
+		return MakeRouteData(raptor_router_->BuildRoute(GetStopId(from), GetStopId(to)));
+	}
+
+	RouteData TransportRouter::CalculateTimetableRoute(std::string_view from, std::string_view to, double departure_time) const {
+		CheckBuilt();
+		return MakeRouteData(timetable_router_->BuildRoute(GetStopId(from), GetStopId(to), departure_time));
+	}
+
+	StopId TransportRouter::GetStopId(std::string_view stop_name) const {
+		const Stop* stop = tc_.FindStop(stop_name);
+		if (stop == nullptr) {
+			throw std::out_of_range("Unknown stop: " + std::string(stop_name));
+		}
+		return stop->id;
+	}
+
+	RouteData TransportRouter::MakeRouteData(const std::optional<RaptorRouter::Journey>& journey) const {
+		RouteData result;
+		if (journey) {
+			result.founded = true;
+			result.total_time = journey->total_time;
+			for (const auto& ride : journey->rides) {
+				result.items.emplace_back(RouteItem{
+					tc_.GetStop(ride.bus->stops[ride.board_position]).stop_name,
+					0,
+					ride.wait_time,
+					EdgeType::WAIT });
+				result.items.emplace_back(RouteItem{
+					ride.bus->bus_name,
+					static_cast<int>(ride.alight_position - ride.board_position),
+					ride.ride_time,
+					EdgeType::TRAVEL });
+			}
+		}
+		return result;
+	}
+
+	void TransportRouter::BuildRaptorRouter() {
+		const double velocity_factor = settings_.bus_velocity * METERS_PER_KM / MIN_PER_HOUR;
+		raptor_router_ = std::make_unique<RaptorRouter>(tc_, settings_.bus_wait_time, velocity_factor);
+	}
+
 	void TransportRouter::BuildGraph() {
 		const size_t total_stops = tc_.GetAllStopsCount();
 		const double velocity_factor = settings_.bus_velocity * METERS_PER_KM / MIN_PER_HOUR;
-		size_t vertex_id = 0;
 		Graph graph(total_stops * 2);
 		graph_ = std::move(graph);
-		vertexes_.reserve(total_stops);
-
-		for (const auto& [stopname, stop] : tc_.GetAllStops()) {
-			vertexes_.insert({ stopname, {vertex_id, vertex_id + 1} });
-			++vertex_id;
-			auto edge_id = graph_.AddEdge({
-					vertexes_.at(stopname).wait,
-					vertexes_.at(stopname).travel,
-					settings_.bus_wait_time
-				});
-			edges_info_.insert({ edge_id,
-				{ stop->stop_name,
-					0,	// span == 0   
-					0.0, 
-					EdgeType::WAIT					
-				} });
-
-			++vertex_id;
+
+		size_t edge_count = total_stops;
+		for (const auto& bus : tc_.GetAllBuses()) {
+			edge_count += bus.stops.size() * (bus.stops.size() - std::min<size_t>(bus.stops.size(), 1)) / 2;
+		}
+		edges_info_.reserve(edge_count);
+
+		for (StopId stop = 0; stop < total_stops; ++stop) {
+			graph_.AddEdge({ GetWaitVertex(stop), GetTravelVertex(stop), settings_.bus_wait_time });
+			edges_info_.push_back({ stop,
+				0,	// span == 0   
+				EdgeType::WAIT });
 		}
 
 		for (const auto& bus : tc_.GetAllBuses()) {
 			const size_t bus_stop_count = bus.stops.size();
-			std::vector<double> distances(bus_stop_count, 0.0);
+			const ArrayView<double> distances = tc_.GetBusPrefixDistances(bus.id);
 
-			//      
-			for (size_t i = 1; i < bus_stop_count; ++i) {
-				distances[i] = distances[i - 1] + static_cast<double>(tc_.GetDistance(bus.stops[i - 1], bus.stops[i]).meters);
-			}
-
-			for (size_t it_from = 0; it_from < bus_stop_count - 1; ++it_from) {
-				int span_count = 0;
+			for (size_t it_from = 0; it_from + 1 < bus_stop_count; ++it_from) {
+				uint32_t span_count = 0;
 				for (size_t it_to = it_from + 1; it_to < bus_stop_count; ++it_to) {
 					double road_distance = distances[it_to] - distances[it_from];
-					auto edge_id = graph_.AddEdge({
-							vertexes_.at(bus.stops[it_from]->stop_name).travel,
-							vertexes_.at(bus.stops[it_to]->stop_name).wait,
+					graph_.AddEdge({
+							GetTravelVertex(bus.stops[it_from]),
+							GetWaitVertex(bus.stops[it_to]),
 							road_distance / velocity_factor
 						});
-					edges_info_.insert({ edge_id,
-						{ bus.bus_name,
-							++span_count,
-							0.0,
-							EdgeType::TRAVEL
-						} });
+					edges_info_.push_back({ bus.id, ++span_count, EdgeType::TRAVEL });
+				}
+			}
+		}
+	}
+
+	void TransportRouter::LoadGraph() {
+		//      ,     :
+		//        
+		const RoutingImage& image = *routing_image_;
+		const size_t stop_count = tc_.GetAllStopsCount();
+		const size_t bus_count = tc_.GetAllBuses().size();
+		CheckImage(image.GetVertexCount() == 2 * stop_count, "vertex count does not match stop count");
+		graph_ = Graph(image.GetVertexCount());
+		edges_info_.reserve(image.GetEdgeCount());
+		for (size_t edge = 0; edge < image.GetEdgeCount(); ++edge) {
+			const EdgeInfo info{ image.GetEdgeOwner()[edge], image.GetEdgeSpanCount()[edge], image.GetEdgeType(edge) };
+			if (info.type == EdgeType::WAIT) {
+				CheckImage(info.owner < stop_count, "wait edge owner is out of range");
+			}
+			else {
+				CheckImage(info.owner < bus_count, "travel edge owner is out of range");
+				CheckImage(info.span_count < tc_.GetBus(info.owner).stops.size(), "travel edge span count is out of range");
+			}
+			const double weight = image.GetEdgeWeight()[edge];
+			CheckImage(weight >= 0.0, "edge weight should be non-negative");
+			graph_.AddEdge({ image.GetEdgeFrom()[edge], image.GetEdgeTo()[edge], weight });
+			edges_info_.push_back(info);
+		}
+	}
+
+	void TransportRouter::BuildRouter() {
+		switch (settings_.router_type) {
+		case RouterType::DIJKSTRA:
+			router_ = std::make_unique<graph::DijkstraRouter<double>>(graph_);
+			break;
+		case RouterType::A_STAR:
+			heuristic_factor_ = ComputeHeuristicFactor();
+			router_ = std::make_unique<graph::DijkstraRouter<double>>(graph_,
+				[this](graph::VertexId vertex, graph::VertexId target) { return EstimateTime(vertex, target); });
+			break;
+		case RouterType::BIDIRECTIONAL:
+			graph_.BuildIncomingIndex();
+			router_ = std::make_unique<graph::BidirectionalRouter<double>>(graph_);
+			break;
+		case RouterType::CONTRACTION_HIERARCHY:
+			//      ,   
+			if (routing_image_ && routing_image_->HasHierarchy()) {
+				router_ = std::make_unique<graph::ContractionHierarchy<double>>(routing_image_->GetHierarchy());
+			}
+			else {
+				router_ = std::make_unique<graph::ContractionHierarchy<double>>(graph_);
+			}
+			break;
+		case RouterType::ALL_PAIRS:
+			if (settings_.router_compact_table) {
+				router_ = MakeTableRouter<graph::Router<double, float, uint32_t>>();
+			}
+			else {
+				router_ = MakeTableRouter<graph::Router<double>>();
+			}
+			break;
+		case RouterType::RAPTOR:
+			throw std::logic_error("RAPTOR router works without the graph");
+		}
+	}
+
+	double TransportRouter::ComputeHeuristicFactor() const {
+		const double velocity_factor = settings_.bus_velocity * METERS_PER_KM / MIN_PER_HOUR;
+		double min_ratio = 1.0;
+		std::vector<double> geo_distances;
+		for (const auto& bus : tc_.GetAllBuses()) {
+			if (bus.stops.size() < 2) {
+				continue;
+			}
+			geo_distances.resize(bus.stops.size() - 1);
+			tc_.GetStopCoordinates().ComputeDistances(bus.stops.data(), bus.stops.data() + 1, geo_distances.size(), geo_distances.data());
+			const ArrayView<double> road_distances = tc_.GetBusPrefixDistances(bus.id);
+			for (size_t i = 1; i < bus.stops.size(); ++i) {
+				const double geo_distance = geo_distances[i - 1];
+				if (geo_distance > 0.0) {
+					const double road_distance = road_distances[i] - road_distances[i - 1];
+					min_ratio = std::min(min_ratio, road_distance / geo_distance);
 				}
 			}
 		}
-		router_ = std::make_unique<graph::Router<double>>(graph_);
+		return std::max(min_ratio, 0.0) * HEURISTIC_SAFETY_FACTOR / velocity_factor;
+	}
+
+	double TransportRouter::EstimateTime(graph::VertexId vertex, graph::VertexId target) const {
+		const StopId stop_from = static_cast<StopId>(vertex / 2);
+		const StopId stop_to = static_cast<StopId>(target / 2);
+		if (stop_from == stop_to) {
+			return 0.0;
+		}
+		//        
+		const double wait_time = vertex % 2 == 0 ? settings_.bus_wait_time : 0.0;
+		return wait_time + tc_.GetStopCoordinates().ComputeDistance(stop_from, stop_to) * heuristic_factor_;
 	}
 
 } // namespace transport_router
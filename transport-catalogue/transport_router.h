@@ -1,17 +1,27 @@
 #pragma once
 
+#include "bidirectional_router.h"
+#include "contraction_hierarchy.h"
+#include "dijkstra_router.h"
+#include "raptor_router.h"
+#include "timetable_router.h"
 #include "router.h"
+#include "routing_image.h"
 #include "transport_catalogue.h"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 
 namespace transport_router {
 
 	constexpr static double METERS_PER_KM = 1000.0;
 	constexpr static double MIN_PER_HOUR  = 60.0;
+	constexpr static double HEURISTIC_SAFETY_FACTOR = 0.999;
 
 	struct RouteItem {
-		std::string edge_name;
+		std::string_view edge_name;
 		int span_count = 0;
 		double time = 0.0;
 		EdgeType type;
@@ -23,34 +33,97 @@ namespace transport_router {
 		bool founded = false;
 	};
 
-	struct VertexWithMirror {
-		size_t wait;
-		size_t travel;
+	//    : times[row * columns + column], nullopt -  
+	struct RouteMatrix {
+		size_t rows = 0;
+		size_t columns = 0;
+		std::vector<std::optional<double>> times;
+	};
+
+	struct ReachableStop {
+		std::string_view stop_name;
+		double time = 0.0;
 	};
 
 	class TransportRouter {
 
-		using Router	= graph::Router<double>;
+		using Router	= graph::RouteBuilder<double>;
 		using Graph		= graph::DirectedWeightedGraph<double>;
-		using Vertexes  = std::unordered_map<std::string_view, VertexWithMirror>;
-		using EdgesInfo = std::unordered_map<graph::EdgeId, RouteItem>;
+
+		// StopId   , BusId -   
+		struct EdgeInfo {
+			uint32_t owner;
+			uint32_t span_count;
+			EdgeType type;
+		};
+		using EdgesInfo = std::vector<EdgeInfo>;
 
 	public:
 		explicit TransportRouter(const TransportCatalogue& db);
 
 		void SetRoutingSettings(const RoutingSettings& settings);
-		RoutingSettings GetRoutingSettings();
-		RouteData CalculateRoute(std::string_view from, std::string_view to);
+		RoutingSettings GetRoutingSettings() const;
+
+		// Build()  ,          .  
+		// SetRoutingSettings   Build();  std::runtime_error,      
+		void SetRoutingImage(std::shared_ptr<const RoutingImage> image);
+		//     SetRoutingImage
+		void WriteRoutingImage(std::ostream& output) const;
+
+		//     ;     .
+		//   const       
+		void Build();
+
+		RouteData CalculateRoute(std::string_view from, std::string_view to) const;
+		RouteData CalculateTimetableRoute(std::string_view from, std::string_view to, double departure_time) const;
+		RouteMatrix CalculateRouteMatrix(const std::vector<std::string_view>& from, const std::vector<std::string_view>& to) const;
+		std::vector<ReachableStop> CalculateReachable(std::string_view from, double max_time) const;
 
 	private:
 		RoutingSettings settings_;
 		Graph graph_;
 		std::unique_ptr<Router> router_ = nullptr;
+		std::unique_ptr<RaptorRouter> raptor_router_ = nullptr;
+		std::unique_ptr<TimetableRouter> timetable_router_ = nullptr;
+		std::unique_ptr<graph::DijkstraRouter<double>> reachability_router_ = nullptr;
 		const TransportCatalogue& tc_;
-		Vertexes vertexes_;
 		EdgesInfo edges_info_;
+		std::shared_ptr<const RoutingImage> routing_image_;
+		double heuristic_factor_ = 0.0;
+		std::once_flag build_flag_;
+		std::atomic<bool> built_ = false;
 
 		void BuildGraph();
+		void LoadGraph();
+		void BuildRouter();
+		double ComputeHeuristicFactor() const;
+
+		//      ,   ,  
+		template <typename TableRouter>
+		std::unique_ptr<Router> MakeTableRouter() const {
+			using Cell = typename TableRouter::RouteInternalData;
+			if (routing_image_ && routing_image_->GetRouteTable() != nullptr) {
+				if (routing_image_->GetRouteTableCellSize() != sizeof(Cell)) {
+					throw std::runtime_error("Routing image has another route table format");
+				}
+				return std::make_unique<TableRouter>(graph_, static_cast<const Cell*>(routing_image_->GetRouteTable()));
+			}
+			return std::make_unique<TableRouter>(graph_, settings_.router_thread_count);
+		}
+		double EstimateTime(graph::VertexId vertex, graph::VertexId target) const;
+		RouteData CalculateRaptorRoute(std::string_view from, std::string_view to) const;
+		void CheckBuilt() const;
+		StopId GetStopId(std::string_view stop_name) const;
+
+		//      StopId
+		static graph::VertexId GetWaitVertex(StopId stop) {
+			return 2 * static_cast<graph::VertexId>(stop);
+		}
+		static graph::VertexId GetTravelVertex(StopId stop) {
+			return 2 * static_cast<graph::VertexId>(stop) + 1;
+		}
+		void BuildRaptorRouter();
+		RouteData MakeRouteData(const std::optional<RaptorRouter::Journey>& journey) const;
 	};
 
 } // namespace transport_router
\ No newline at end of file